@@ -1,8 +1,9 @@
 /*
- * Copyright (c) 2024-2025 WangBin <wbsecg1 at gmail.com>
+ * Copyright (c) 2024-2026 WangBin <wbsecg1 at gmail.com>
  */
 #include "mdk/c/AudioFrame.h"
 #include "mdk/AudioFrame.h"
+#include "FramePool.h"
 #include <atomic>
 #include <cassert>
 #include <cstdlib>
@@ -13,6 +14,8 @@ using namespace MDK_NS;
 struct mdkAudioFrame {
     AudioFrame frame;
     atomic<int> ref = 1;
+    FramePool<mdkAudioFrame>* pool = nullptr; // null if not from a pool
+    mdkAudioFrameAPI api{}; // api.object == this. api and object are allocated together
 };
 
 static AudioFormat::SampleFormat fromC(MDK_SampleFormat fmt)
@@ -53,14 +56,23 @@ static MDK_SampleFormat toC(AudioFormat::SampleFormat fmt)
 #undef CASE_FMT
 }
 
-mdkAudioFrameAPI* MDK_AudioFrame_toC(const AudioFrame& frame);
+mdkAudioFrameAPI* MDK_AudioFrame_toC(const AudioFrame& frame, FramePool<mdkAudioFrame>* pool = nullptr);
 
 extern "C" {
 static void init_mdkAudioFrameAPI(mdkAudioFrameAPI* p);
 
+static mdkAudioFrame* new_mdkAudioFrame()
+{
+    auto f = new mdkAudioFrame();
+    f->api.object = f;
+    init_mdkAudioFrameAPI(&f->api);
+    return f;
+}
+
 
 void init_mdkAudioFrameAPI(mdkAudioFrameAPI* p)
 {
+    p->size = sizeof(mdkAudioFrameAPI);
     p->planeCount = [](struct mdkAudioFrame* f) { return f->frame.format().planeCount();};
     p->sampleFormat = [](struct mdkAudioFrame* f) { return toC(f->frame.format().sampleFormat());};
     p->channelMask = [](struct mdkAudioFrame* f) { return (uint64_t)f->frame.format().channelMap();};
@@ -86,11 +98,9 @@ void init_mdkAudioFrameAPI(mdkAudioFrameAPI* p)
 
 mdkAudioFrameAPI* mdkAudioFrameAPI_new(enum MDK_SampleFormat format, int channels, int sampleRate, int samples)
 {
-    mdkAudioFrameAPI* p = new mdkAudioFrameAPI();
-    p->object = new mdkAudioFrame();
-    p->object->frame = AudioFrame({fromC(format), channels, sampleRate});
-    init_mdkAudioFrameAPI(p);
-    return p;
+    auto f = new_mdkAudioFrame();
+    f->frame = AudioFrame({fromC(format), channels, sampleRate});
+    return &f->api;
 }
 
 void mdkAudioFrameAPI_delete(mdkAudioFrameAPI** pp)
@@ -100,8 +110,13 @@ void mdkAudioFrameAPI_delete(mdkAudioFrameAPI** pp)
 
 mdkAudioFrameAPI* mdkAudioFrameAPI_ref(mdkAudioFrameAPI* p)
 {
-    if (p)
-        p->object->ref++;
+    if (!p)
+        return p;
+    if (p->object->ref == 0) { // borrowed view
+        assert(false && "audio frame view escapes the callback. use to() or mdkAudioFrameAPI_new() to create a new frame instead");
+        return MDK_AudioFrame_toC(p->object->frame);
+    }
+    p->object->ref++;
     return p;
 }
 
@@ -109,24 +124,63 @@ void mdkAudioFrameAPI_unref(mdkAudioFrameAPI** pp)
 {
     if (!pp || !*pp)
         return;
-    auto p = *pp;
-    if (--p->object->ref == 0) {
-        delete p->object;
-        delete p;
-    }
+    auto f = (*pp)->object;
     *pp = nullptr;
+    assert(f->ref > 0 && "audio frame view is not owned by user");
+    if (--f->ref != 0)
+        return;
+    auto pool = f->pool;
+    if (!pool) {
+        delete f;
+        return;
+    }
+    f->frame = AudioFrame(); // release samples now instead of when the node is reused
+    f->ref = 1;
+    if (!pool->recycle(f))
+        delete f;
+    pool->release();
 }
 } // extern "C"
 
-mdkAudioFrameAPI* MDK_AudioFrame_toC(const AudioFrame& frame)
+mdkAudioFrameAPI* MDK_AudioFrame_toC(const AudioFrame& frame, FramePool<mdkAudioFrame>* pool)
 {
     if (!frame && frame.timestamp() != TimestampEOS) // TODO: special frames, e.g. EOS
         return nullptr;
-    mdkAudioFrameAPI* api = new mdkAudioFrameAPI();
-    api->object = new mdkAudioFrame();
-    api->object->frame = frame;
-    init_mdkAudioFrameAPI(api);
-    return api;
+    mdkAudioFrame* f = nullptr;
+    if (pool) {
+        f = pool->acquire();
+        f->pool = pool;
+    } else {
+        f = new_mdkAudioFrame();
+    }
+    f->frame = frame;
+    return &f->api;
+}
+
+void MDK_AudioFrame_view(AudioFrame& frame, int track, void (*cb)(const mdkAudioFrameAPI*, int, void*), void* opaque)
+{
+    if (!frame && frame.timestamp() != TimestampEOS) {
+        cb(nullptr, track, opaque);
+        return;
+    }
+    mdkAudioFrame f; // no heap allocation
+    f.ref.store(0, memory_order_relaxed); // not owned by anyone, ref() and unref() are invalid
+    f.frame = std::move(frame);
+    f.api.object = &f;
+    init_mdkAudioFrameAPI(&f.api);
+    cb(&f.api, track, opaque);
+    assert(f.ref == 0 && "audio frame view escapes the callback");
+    frame = std::move(f.frame);
+}
+
+AudioFormat MDK_AudioFormat_fromC(MDK_SampleFormat format, int channels, int sampleRate)
+{
+    return {fromC(format), channels, sampleRate};
+}
+
+FramePool<mdkAudioFrame>* MDK_AudioFrame_newPool(int capacity)
+{
+    return new FramePool<mdkAudioFrame>(capacity, new_mdkAudioFrame, [](mdkAudioFrame* f) { delete f; });
 }
 
 AudioFrame MDK_AudioFrame_fromC(mdkAudioFrameAPI* p)
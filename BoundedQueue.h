@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2026 WangBin <wbsecg1 at gmail.com>
+ */
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/*
+  Fixed capacity lock-free queue(D. Vyukov's bounded MPMC queue). Elements are preallocated and reused, push() and pop() never allocate.
+  Any thread can push or pop, so a producer can drop the oldest element by pop() if queue is full.
+ */
+template<class T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity)
+        : capacity_(capacity > 0 ? capacity : 1)
+        , cells_(new Cell[capacity_])
+    {
+        for (size_t i = 0; i < capacity_; ++i)
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    template<class U>
+    bool push(U&& value) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            auto& c = cells_[pos % capacity_];
+            const auto seq = c.seq.load(std::memory_order_acquire);
+            const auto diff = (ptrdiff_t)seq - (ptrdiff_t)pos;
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    c.value = std::forward<U>(value);
+                    c.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // full
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool pop(T& value) {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            auto& c = cells_[pos % capacity_];
+            const auto seq = c.seq.load(std::memory_order_acquire);
+            const auto diff = (ptrdiff_t)seq - (ptrdiff_t)(pos + 1);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = std::move(c.value);
+                    c.value = T();
+                    c.seq.store(pos + capacity_, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // empty
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+// approximate if accessed concurrently
+    size_t size() const {
+        const auto head = head_.load(std::memory_order_relaxed);
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> seq;
+        T value;
+    };
+    const size_t capacity_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<size_t> head_ = 0;
+    alignas(64) std::atomic<size_t> tail_ = 0;
+};
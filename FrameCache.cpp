@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) 2026 WangBin <wbsecg1 at gmail.com>
+ */
+#include "FrameCache.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iterator>
+
+static int64_t frameBytes(const VideoFrame& frame)
+{
+    int64_t bytes = 0;
+    for (int i = 0; i < frame.format().planeCount(); ++i)
+        bytes += (int64_t)frame.bytesPerLine(i) * frame.height(i);
+    if (bytes <= 0) // hw frame
+        bytes = (int64_t)frame.width() * frame.height() * 3 / 2;
+    return bytes;
+}
+
+FrameCache::~FrameCache()
+{
+    {
+        const lock_guard<mutex> lock(mtx_);
+        stop_ = true;
+        cv_.notify_all();
+    }
+    if (worker_.joinable())
+        worker_.join();
+}
+
+void FrameCache::discontinue()
+{
+    const lock_guard<mutex> lock(mtx_);
+    last_ = -1;
+}
+
+void FrameCache::add(const VideoFrame& frame)
+{
+    const auto t = frame.timestamp();
+    if (!frame || t < 0 || t == TimestampEOS)
+        return;
+    const lock_guard<mutex> lock(mtx_);
+    double prev = -1;
+    if (last_ >= 0 && t > last_ && (dt_ <= 0 || t - last_ < dt_ * 1.5)) {
+        prev = last_;
+        if (dt_ <= 0 || t - last_ < dt_)
+            dt_ = t - last_;
+    }
+    last_ = t;
+    if (cursor_ < 0)
+        focus_ = t;
+    auto it = frames_.find(t);
+    if (it != frames_.end()) {
+        if (prev >= 0)
+            it->second.prev = prev;
+        return;
+    }
+    const auto bytes = frameBytes(frame);
+    it = frames_.emplace(t, Entry{frame, prev, bytes}).first;
+    bytes_ += bytes;
+    // join the following run, e.g. decoded after stepping back to the previous gop
+    if (const auto next = std::next(it); next != frames_.end() && next->second.prev < 0 && dt_ > 0 && next->first - t < dt_ * 1.5)
+        next->second.prev = t;
+    evict();
+}
+
+bool FrameCache::step(int n, VideoFrame& frame, int64_t& ms)
+{
+    const lock_guard<mutex> lock(mtx_);
+    return present(walk(n), frame, ms);
+}
+
+void FrameCache::stepAsync(int n, string url, int64_t startTime, StepCallback cb)
+{
+    const lock_guard<mutex> lock(mtx_);
+    steps_.push_back({n, std::move(url), startTime, std::move(cb), generation_});
+    if (!worker_.joinable())
+        worker_ = thread([this]{ run(); });
+    cv_.notify_all();
+}
+
+bool FrameCache::stepping()
+{
+    const lock_guard<mutex> lock(mtx_);
+    return !steps_.empty();
+}
+
+bool FrameCache::at(double t, VideoFrame& frame, int64_t& ms)
+{
+    const lock_guard<mutex> lock(mtx_);
+    auto it = frames_.upper_bound(t);
+    double found = -1;
+    if (it != frames_.cbegin()) {
+        const auto f = std::prev(it)->first;
+        if (f == t || (it != frames_.cend() && it->second.prev == f))
+            found = f;
+    }
+    return present(found, frame, ms);
+}
+
+double FrameCache::target(int n)
+{
+    const lock_guard<mutex> lock(mtx_);
+    return cursor_ + n * (dt_ > 0 ? dt_ : 1.0/25.0);
+}
+
+bool FrameCache::detached()
+{
+    const lock_guard<mutex> lock(mtx_);
+    return cursor_ >= 0;
+}
+
+double FrameCache::cursor()
+{
+    const lock_guard<mutex> lock(mtx_);
+    return cursor_;
+}
+
+void FrameCache::attach()
+{
+    const lock_guard<mutex> lock(mtx_);
+    cursor_ = -1;
+    last_ = -1;
+}
+
+void FrameCache::clear()
+{
+    const lock_guard<mutex> lock(mtx_);
+    generation_++;
+    frames_.clear();
+    bytes_ = 0;
+    cursor_ = last_ = focus_ = -1;
+    dt_ = 0;
+}
+
+void FrameCache::stats(mdkFrameCacheStats* s)
+{
+    const lock_guard<mutex> lock(mtx_);
+    s->hits = hits_;
+    s->misses = misses_;
+    s->frames = (int)frames_.size();
+    s->bytes = bytes_;
+    s->budget = budget_;
+}
+
+double FrameCache::walk(int n) const
+{
+    auto t = cursor_ >= 0 ? cursor_ : last_;
+    for (int i = 0; t >= 0 && i < std::abs(n); ++i) {
+        if (n < 0) {
+            const auto it = frames_.find(t);
+            t = it != frames_.cend() && frames_.count(it->second.prev) ? it->second.prev : -1;
+        } else {
+            const auto it = frames_.upper_bound(t);
+            t = it != frames_.cend() && it->second.prev == t ? it->first : -1;
+        }
+    }
+    return t;
+}
+
+void FrameCache::insert(const vector<VideoFrame>& run)
+{
+    const lock_guard<mutex> lock(mtx_);
+    double prev = -1;
+    for (const auto& frame : run) {
+        const auto t = frame.timestamp();
+        if (prev >= 0 && (dt_ <= 0 || t - prev < dt_))
+            dt_ = t - prev;
+        auto it = frames_.find(t);
+        if (it == frames_.end()) {
+            const auto bytes = frameBytes(frame);
+            it = frames_.emplace(t, Entry{frame, prev, bytes}).first;
+            bytes_ += bytes;
+        } else if (prev >= 0) {
+            it->second.prev = prev;
+        }
+        prev = t;
+    }
+    // join the following run, i.e. the start frame of a backward step
+    if (const auto next = frames_.upper_bound(prev); prev >= 0 && next != frames_.end() && next->second.prev < 0 && dt_ > 0 && next->first - prev < dt_ * 1.5)
+        next->second.prev = prev;
+    evict();
+}
+
+bool FrameCache::present(double t, VideoFrame& frame, int64_t& ms)
+{
+    if (t < 0) {
+        misses_++;
+        return false;
+    }
+    hits_++;
+    cursor_ = focus_ = t;
+    frame = frames_[t].frame;
+    ms = (int64_t)llround(t * 1000.0);
+    return true;
+}
+
+void FrameCache::evict()
+{
+    while (bytes_ > budget_ && frames_.size() > 1) {
+        const auto first = frames_.begin();
+        const auto last = std::prev(frames_.end());
+        const auto it = focus_ - first->first > last->first - focus_ ? first : last;
+        bytes_ -= it->second.bytes;
+        frames_.erase(it);
+    }
+}
+
+void FrameCache::run()
+{
+    // decoded gop [key frame, end), written in hidden player video thread after a seek is finished
+    mutex gop_mtx;
+    condition_variable gop_cv;
+    vector<VideoFrame> gop;
+    double end = 0;
+    double dt = 0; // frame duration, 0 if unknown
+    bool collecting = false;
+    bool collected = false;
+    bool seeked = false;
+    int64_t result = -1;
+    string url; // opened by hidden player
+    bool opened = false;
+    int64_t start_time = 0;
+    atomic<double> sync = 0; // hidden player clock: a bit later than the last decoded frame, so frames are neither late nor waited
+    // declared after the states used by its callbacks, so callbacks finish before states are destroyed
+    Player player;
+    const auto wait = [&](bool& flag){
+        unique_lock<mutex> lock(gop_mtx);
+        while (!flag) {
+            gop_cv.wait_for(lock, chrono::milliseconds(10));
+            if (stopped())
+                return false;
+        }
+        flag = false;
+        return true;
+    };
+    const auto finish = [&](int64_t ret){
+        const lock_guard<mutex> lock(gop_mtx);
+        result = ret;
+        seeked = true;
+        collecting = ret >= 0 && end > 0;
+        gop_cv.notify_all();
+    };
+    const auto syncTo = [&](double t){ // t: frame timestamp
+        sync.store(t - double(start_time) / 1000.0 + (dt > 0 ? dt * 2.0 : 1.0), memory_order_relaxed);
+    };
+    player.setActiveTracks(MediaType::Audio, {});
+    player.setActiveTracks(MediaType::Subtitle, {});
+    player.onSync([&]{ return sync.load(memory_order_relaxed); });
+    player.onFrame<VideoFrame>([&](VideoFrame& frame, int){
+        const auto t = frame.timestamp();
+        const lock_guard<mutex> lock(gop_mtx);
+        if (!collecting)
+            return 0;
+        if (!frame || t == TimestampEOS || t >= end) {
+            collecting = false;
+            collected = true;
+            gop_cv.notify_all();
+            return 0;
+        }
+        if (!gop.empty() && t > gop.back().timestamp())
+            dt = t - gop.back().timestamp();
+        syncTo(t);
+        gop.push_back(frame);
+        return 0;
+    });
+    // decode the gop before frame at t
+    const auto decode = [&](double t){
+        {
+            const lock_guard<mutex> lock(gop_mtx);
+            collecting = collected = false;
+            gop.clear();
+            end = t;
+        }
+        // strictly before t, otherwise the key frame of t is found
+        const auto target = (int64_t)llround(t * 1000.0) - start_time - 1;
+        if (target < 0 || !player.seek(target, SeekFlag(int(SeekFlag::FromStart) | int(SeekFlag::KeyFrame) | int(SeekFlag::Backward)), finish))
+            return false;
+        if (!wait(seeked) || result < 0)
+            return false;
+        {
+            const lock_guard<mutex> lock(gop_mtx);
+            syncTo(double(result + start_time) / 1000.0);
+        }
+        player.set(State::Playing);
+        const bool ok = wait(collected);
+        player.set(State::Paused);
+        return ok;
+    };
+    for (;;) {
+        Step s;
+        double from = -1;
+        bool hit = false;
+        {
+            unique_lock<mutex> lock(mtx_);
+            cv_.wait(lock, [this]{ return stop_ || !steps_.empty(); });
+            if (stop_)
+                break;
+            s = steps_.front(); // popped when finished, so later steps wait
+            if (s.generation == generation_) {
+                from = cursor_ >= 0 ? cursor_ : last_;
+                hit = walk(s.n) >= 0;
+            }
+        }
+        if (!hit && from >= 0 && s.n < 0 && !s.url.empty()) {
+            if (s.url != url) {
+                url = s.url;
+                start_time = s.start_time;
+                {
+                    const lock_guard<mutex> lock(gop_mtx);
+                    end = 0;
+                }
+                player.setMedia(url.data());
+                player.prepare(0, [&](int64_t position, bool*){
+                    finish(position);
+                    return true;
+                });
+                opened = wait(seeked) && result >= 0;
+            }
+            if (opened && decode(from)) {
+                vector<VideoFrame> frames;
+                {
+                    const lock_guard<mutex> lock(gop_mtx);
+                    frames.swap(gop);
+                }
+                insert(frames);
+            }
+        }
+        VideoFrame frame;
+        int64_t ms = -2;
+        {
+            const lock_guard<mutex> lock(mtx_);
+            if (s.generation == generation_ && !present(walk(s.n), frame, ms)) {
+                ms = cursor_ >= 0 ? (int64_t)llround((cursor_ + s.n * (dt_ > 0 ? dt_ : 1.0/25.0)) * 1000.0) : -1;
+                cursor_ = last_ = -1; // decoder is seeking
+            }
+        }
+        s.cb(frame, ms);
+        const lock_guard<mutex> lock(mtx_);
+        steps_.pop_front();
+    }
+    player.set(State::Stopped);
+}
+
+bool FrameCache::stopped()
+{
+    const lock_guard<mutex> lock(mtx_);
+    return stop_;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2026 WangBin <wbsecg1 at gmail.com>
+ */
+#pragma once
+#include "mdk/c/Player.h"
+#include "mdk/Player.h"
+#include "mdk/VideoFrame.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace MDK_NS;
+
+/*
+  Decoded video frames around current position, keyed by timestamp. Frames are added when delivered by decoder, e.g. in playback and forward steps,
+  and linked to the previous frame delivered continuously, so a frame step can be served without decoding if the linked frame is cached.
+  When a frame from cache is presented, the cursor is detached from decoder position until next decoder seek.
+  Backward steps are served in order in a worker thread. If missed, the gop before the start frame is decoded by a hidden player(no audio and rendering) and cached.
+ */
+class FrameCache {
+public:
+/*
+  frame: the stepped frame at ms(timestamp in milliseconds) if hit. Otherwise ms is timestamp to seek by decoder, -1 to step by decoder, or -2 if dropped by clear()
+ */
+    using StepCallback = function<void(const VideoFrame& frame, int64_t ms)>;
+
+    explicit FrameCache(int64_t budget) : budget_(budget) {}
+    ~FrameCache();
+
+// next frame is not continuous, e.g. after seek
+    void discontinue();
+    void add(const VideoFrame& frame);
+// step n frames from cursor, or from the last delivered frame if not detached
+    bool step(int n, VideoFrame& frame, int64_t& ms);
+// step in worker thread after pending steps. startTime: media start time of url in milliseconds
+    void stepAsync(int n, string url, int64_t startTime, StepCallback cb);
+// has pending steps
+    bool stepping();
+// the frame displayed at t if t is in a continuous cached range
+    bool at(double t, VideoFrame& frame, int64_t& ms);
+// estimated timestamp n frames from cursor
+    double target(int n);
+    bool detached();
+// -1 if not detached
+    double cursor();
+// decoder is seeking, cursor follows decoder again
+    void attach();
+    void clear();
+    void stats(mdkFrameCacheStats* s);
+
+private:
+    struct Entry {
+        VideoFrame frame;
+        double prev; // timestamp of the previous continuous frame, or -1
+        int64_t bytes;
+    };
+
+    struct Step {
+        int n;
+        string url;
+        int64_t start_time;
+        StepCallback cb;
+        int64_t generation;
+    };
+
+// timestamp n frames from cursor, or -1 if not continuously cached
+    double walk(int n) const;
+// add decoded frames of a continuous run
+    void insert(const vector<VideoFrame>& run);
+    bool present(double t, VideoFrame& frame, int64_t& ms);
+// the farthest frame from focus first
+    void evict();
+    void run();
+    bool stopped();
+
+    mutex mtx_;
+    map<double, Entry> frames_;
+    const int64_t budget_;
+    int64_t bytes_ = 0;
+    double last_ = -1; // the last delivered frame
+    double cursor_ = -1; // the presented frame from cache
+    double focus_ = -1;
+    double dt_ = 0; // frame duration
+    int64_t hits_ = 0;
+    int64_t misses_ = 0;
+
+    condition_variable cv_;
+    deque<Step> steps_; // the front is running
+    int64_t generation_ = 0; // increased by clear()
+    bool stop_ = false;
+    thread worker_;
+};
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2026 WangBin <wbsecg1 at gmail.com>
+ */
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+/*
+  Bounded lock-free free list of frame objects.
+  Slots are exchanged atomically, so there is no ABA problem and a node can be returned from any thread.
+  The pool is alive as long as the owner or any node acquired from it is alive. Node type T is opaque here,
+  nodes are preallocated to fill the capacity, and allocated from heap if the pool is empty.
+ */
+template<class T>
+class FramePool {
+public:
+    static constexpr int kMaxCapacity = 64;
+
+    FramePool(int capacity, T* (*create)(), void (*destroy)(T*))
+        : create_(create)
+        , destroy_(destroy)
+    {
+        setCapacity(capacity);
+    }
+/*!
+  \brief setCapacity
+  Preallocate nodes if capacity grows, or free pooled nodes out of range if shrinks. Nodes in use are not affected.
+ */
+    void setCapacity(int value) {
+        value = std::clamp(value, 0, kMaxCapacity);
+        const int old = capacity_.exchange(value, std::memory_order_relaxed);
+        for (int i = value; i < old; ++i) {
+            if (auto node = slots_[i].exchange(nullptr, std::memory_order_acquire))
+                destroy_(node);
+        }
+        for (int i = 0; i < value; ++i) {
+            if (slots_[i].load(std::memory_order_relaxed))
+                continue;
+            auto node = create_();
+            T* expected = nullptr;
+            if (!slots_[i].compare_exchange_strong(expected, node, std::memory_order_release, std::memory_order_relaxed))
+                destroy_(node);
+        }
+    }
+/*!
+  \brief acquire
+  Get a recycled node, or a new node if pool is empty. A reference of pool is added, and MUST be released when the node is recycled or destroyed
+ */
+    T* acquire() {
+        ref_.fetch_add(1, std::memory_order_relaxed);
+        const int n = capacity_.load(std::memory_order_relaxed);
+        for (int i = 0; i < n; ++i) {
+            if (!slots_[i].load(std::memory_order_relaxed))
+                continue;
+            if (auto node = slots_[i].exchange(nullptr, std::memory_order_acquire)) {
+                hits_.fetch_add(1, std::memory_order_relaxed);
+                return node;
+            }
+        }
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return create_();
+    }
+/*!
+  \brief recycle
+  Put back a node whose state is already reset. Does not release the reference added by acquire()
+  \return false if pool is full, then caller owns the node
+ */
+    bool recycle(T* node) {
+        const int n = capacity_.load(std::memory_order_relaxed);
+        for (int i = 0; i < n; ++i) {
+            T* expected = nullptr;
+            if (slots_[i].compare_exchange_strong(expected, node, std::memory_order_release, std::memory_order_relaxed))
+                return true;
+        }
+        return false;
+    }
+
+    void retain() {
+        ref_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release() {
+        if (ref_.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return;
+        for (auto& s : slots_) {
+            if (auto node = s.exchange(nullptr, std::memory_order_acquire))
+                destroy_(node);
+        }
+        delete this;
+    }
+
+    uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+    uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+    int capacity() const { return capacity_.load(std::memory_order_relaxed); }
+
+private:
+    ~FramePool() = default;
+
+    std::atomic<int> ref_ = 1; // owner + acquired nodes
+    std::atomic<int> capacity_ = 0;
+    std::atomic<uint64_t> hits_ = 0;
+    std::atomic<uint64_t> misses_ = 0;
+    T* (*create_)();
+    void (*destroy_)(T*);
+    std::atomic<T*> slots_[kMaxCapacity] = {};
+};
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2026 WangBin <wbsecg1 at gmail.com>
+ */
+#include "KeyframeIndex.h"
+#include "mdk/Player.h"
+#include <algorithm>
+
+using namespace MDK_NS;
+
+extern bool MDK_ProbeCache_loadKeyframes(const char* url, vector<int64_t>& t);
+extern void MDK_ProbeCache_storeKeyframes(const char* url, const vector<int64_t>& t);
+
+KeyframeIndex::KeyframeIndex(string url)
+    : url_(std::move(url))
+{
+    complete_ = MDK_ProbeCache_loadKeyframes(url_.data(), t_);
+}
+
+KeyframeIndex::~KeyframeIndex()
+{
+    {
+        const lock_guard<mutex> lock(build_mtx_);
+        stop_ = true;
+        build_cv_.notify_all();
+    }
+    if (build_.joinable())
+        build_.join();
+}
+
+void KeyframeIndex::add(int64_t t)
+{
+    const lock_guard<mutex> lock(mtx_);
+    const auto it = lower_bound(t_.begin(), t_.end(), t);
+    if (it == t_.end() || *it != t)
+        t_.insert(it, t);
+}
+
+bool KeyframeIndex::floor(int64_t t, int64_t& k)
+{
+    const lock_guard<mutex> lock(mtx_);
+    if (!complete_)
+        return false;
+    const auto it = upper_bound(t_.cbegin(), t_.cend(), t);
+    if (it == t_.cbegin())
+        return false;
+    k = *prev(it);
+    return true;
+}
+
+int KeyframeIndex::copy(int64_t* t, int count, bool* complete)
+{
+    const lock_guard<mutex> lock(mtx_);
+    if (complete)
+        *complete = complete_;
+    if (t)
+        std::copy_n(t_.cbegin(), std::min<size_t>(std::max(count, 0), t_.size()), t);
+    return (int)t_.size();
+}
+
+void KeyframeIndex::build()
+{
+    bool complete = false;
+    copy(nullptr, 0, &complete);
+    const lock_guard<mutex> lock(build_mtx_);
+    if (complete || build_.joinable())
+        return;
+    build_ = thread([this]{ run(); });
+}
+
+void KeyframeIndex::run()
+{
+    int64_t result = -1;
+    bool done = false;
+    // declared after the states used by its callbacks, so callbacks finish before states are destroyed
+    Player player;
+    const auto wait = [&]{
+        unique_lock<mutex> lock(build_mtx_);
+        build_cv_.wait(lock, [&]{ return done || stop_; });
+        done = false;
+        return !stop_;
+    };
+    const auto finish = [&](int64_t ret){
+        const lock_guard<mutex> lock(build_mtx_);
+        result = ret;
+        done = true;
+        build_cv_.notify_all();
+    };
+    player.setActiveTracks(MediaType::Audio, {});
+    player.setActiveTracks(MediaType::Subtitle, {});
+    player.setMedia(url_.data());
+    player.prepare(0, [&](int64_t position, bool*){
+        finish(position);
+        return true;
+    });
+    if (!wait() || result < 0)
+        return;
+    int64_t pos = 0;
+    for (;;) {
+        if (!player.seek(pos, SeekFlag(int(SeekFlag::FromStart) | int(SeekFlag::KeyFrame)), finish))
+            break;
+        if (!wait())
+            return;
+        if (result < pos) // no more key frames
+            break;
+        add(result);
+        pos = result + 1;
+    }
+    vector<int64_t> t;
+    {
+        const lock_guard<mutex> lock(mtx_);
+        complete_ = true;
+        t = t_;
+    }
+    MDK_ProbeCache_storeKeyframes(url_.data(), t);
+    player.set(State::Stopped);
+}
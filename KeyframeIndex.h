@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2026 WangBin <wbsecg1 at gmail.com>
+ */
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/*
+  Key frame timestamps of a media, learned from key frame seek results, or a background pass of key frame seeks by a hidden player.
+  A completed index is persisted in probe cache dir.
+ */
+class KeyframeIndex {
+public:
+    explicit KeyframeIndex(string url);
+    ~KeyframeIndex();
+
+    const string& url() const { return url_; }
+
+    void add(int64_t t);
+// the nearest key frame <= t. only a complete index is used, a learned key frame may be not the nearest one
+    bool floor(int64_t t, int64_t& k);
+    int copy(int64_t* t, int count, bool* complete);
+    void build();
+
+private:
+    void run();
+
+    const string url_;
+    mutex mtx_;
+    vector<int64_t> t_; // sorted
+    bool complete_ = false;
+
+    mutex build_mtx_;
+    condition_variable build_cv_;
+    bool stop_ = false;
+    thread build_;
+};
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2025 WangBin <wbsecg1 at gmail.com>
+ * Copyright (c) 2019-2026 WangBin <wbsecg1 at gmail.com>
  */
 #include "mdk/c/MediaInfo.h"
 #include "mdk/MediaInfo.h"
@@ -7,6 +7,9 @@
 #include "MediaInfoInternal.h"
 #include <cassert>
 #include <algorithm>
+#include <cstring>
+#include <new>
+#include <type_traits>
 
 ColorSpace kColorSpaceMap[] = {
     ColorSpaceUnknown,
@@ -155,58 +158,125 @@ static void from_abi(const MediaInfo& in, mdkMediaInfo& out)
     out.priv = &in;
 }
 
+// returns offset of n elements of T in arena, and increases arena size
+template<class T>
+static size_t arena_alloc(size_t& size, size_t n)
+{
+    const auto offset = (size + alignof(T) - 1) / alignof(T) * alignof(T);
+    size = offset + n * sizeof(T);
+    return offset;
+}
+
+template<class T, class InfoAbi>
+static T* arena_fill(uint8_t* arena, size_t offset, const vector<InfoAbi>& in)
+{
+    if (in.empty())
+        return nullptr;
+    auto out = reinterpret_cast<T*>(arena + offset);
+    for (size_t i = 0; i < in.size(); ++i)
+        from_abi(in[i], *new(&out[i]) T{});
+    return out;
+}
+
 void MediaInfoToC(const MediaInfo& abi, MediaInfoInternal* out)
 {
     if (!out)
         return;
-    *out = MediaInfoInternal{};
     out->abi = abi;
-
-    for (const auto& i : out->abi.chapters) {
-        mdkChapterInfo ci;
-        from_abi(i, ci);
-        out->c.push_back(ci);
+    out->info = {};
+    const auto& in = out->abi;
+
+    size_t size = 0;
+    const auto c = arena_alloc<mdkChapterInfo>(size, in.chapters.size());
+    const auto p = arena_alloc<mdkProgramInfo>(size, in.program.size());
+    const auto a = arena_alloc<mdkAudioStreamInfo>(size, in.audio.size());
+    const auto v = arena_alloc<mdkVideoStreamInfo>(size, in.video.size());
+    const auto s = arena_alloc<mdkSubtitleStreamInfo>(size, in.subtitle.size());
+    const auto n = (size + sizeof(max_align_t) - 1) / sizeof(max_align_t);
+    if (n > out->arena_size) {
+        out->arena.reset(new max_align_t[n]);
+        out->arena_size = n;
     }
-    out->info.chapters = nullptr;
-    if (!out->c.empty())
-        out->info.chapters = &out->c[0];
-
-    for (const auto& i : out->abi.program) {
-        mdkProgramInfo pi;
-        from_abi(i, pi);
-        out->p.push_back(pi);
+    auto arena = reinterpret_cast<uint8_t*>(out->arena.get());
+    out->info.chapters = arena_fill<mdkChapterInfo>(arena, c, in.chapters);
+    out->info.programs = arena_fill<mdkProgramInfo>(arena, p, in.program);
+    out->info.audio = arena_fill<mdkAudioStreamInfo>(arena, a, in.audio);
+    out->info.video = arena_fill<mdkVideoStreamInfo>(arena, v, in.video);
+    out->info.subtitle = arena_fill<mdkSubtitleStreamInfo>(arena, s, in.subtitle);
+
+    from_abi(in, out->info);
+}
+
+// FNV-1a
+class Fingerprint {
+public:
+    uint64_t value() const { return h_; }
+
+    template<typename T>
+    Fingerprint& operator<<(const T& v) {
+        static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>);
+        uint8_t b[sizeof(T)];
+        memcpy(b, &v, sizeof(v));
+        return add(b, sizeof(b));
     }
-    out->info.programs = nullptr;
-    if (!out->p.empty())
-        out->info.programs = &out->p[0];
-
-    for (const auto& i : out->abi.audio) {
-        mdkAudioStreamInfo si;
-        from_abi(i, si);
-        out->a.push_back(si);
+
+    Fingerprint& operator<<(const string& v) {
+        *this << v.size();
+        return add(v.data(), v.size());
     }
-    if (!out->a.empty())
-        out->info.audio = &out->a[0];
 
-    for (const auto& i : out->abi.video) {
-        mdkVideoStreamInfo si;
-        from_abi(i, si);
-        out->v.push_back(si);
+    Fingerprint& operator<<(const map<string, string>& m) {
+        *this << m.size();
+        for (const auto& [k, v] : m)
+            *this << k << v;
+        return *this;
     }
-    if (!out->v.empty())
-        out->info.video = &out->v[0];
 
-    for (const auto& i : out->abi.subtitle) {
-        mdkSubtitleStreamInfo si;
-        from_abi(i, si);
-        out->s.push_back(si);
+private:
+    Fingerprint& add(const void* data, size_t size) {
+        auto d = (const uint8_t*)data;
+        for (size_t i = 0; i < size; ++i)
+            h_ = (h_ ^ d[i]) * 0x100000001b3ULL;
+        return *this;
     }
-    if (!out->s.empty())
-        out->info.subtitle = &out->s[0];
 
-    from_abi(out->abi, out->info);
+    uint64_t h_ = 0xcbf29ce484222325ULL;
+};
+
+uint64_t MediaInfoFingerprint(const MediaInfo& abi)
+{
+    Fingerprint h;
+    h << abi.start_time << abi.duration << abi.bit_rate << abi.size << abi.format << abi.streams << abi.metadata;
+    h << abi.chapters.size();
+    for (const auto& i : abi.chapters)
+        h << i.start_time << i.end_time << i.title << i.metadata;
+    h << abi.program.size();
+    for (const auto& i : abi.program) {
+        h << i.id << i.stream.size() << i.metadata;
+        for (auto s : i.stream)
+            h << s;
+    }
+    h << abi.audio.size();
+    for (const auto& i : abi.audio) {
+        const auto& c = i.codec;
+        h << i.index << i.start_time << i.duration << i.frames << i.metadata
+          << c.codec << c.codec_tag << c.bit_rate << c.profile << c.level << c.frame_rate << c.format << c.channels << c.sample_rate << c.block_align << c.frame_size;
+    }
+    h << abi.video.size();
+    for (const auto& i : abi.video) {
+        const auto& c = i.codec;
+        h << i.index << i.start_time << i.duration << i.frames << i.rotation << i.metadata
+          << c.codec << c.codec_tag << c.bit_rate << c.profile << c.level << c.frame_rate << c.format << c.width << c.height << c.b_frames << c.par;
+    }
+    h << abi.subtitle.size();
+    for (const auto& i : abi.subtitle) {
+        const auto& c = i.codec;
+        h << i.index << i.start_time << i.duration << i.metadata << c.codec << c.codec_tag << c.width << c.height;
+    }
+    return h.value();
 }
 
+// entry->priv is the key string in map node, so no iterator is allocated
 template<class InfoAbi, class Info>
 static bool MDK_GetMetaData(const Info* info, mdkStringMapEntry* entry)
 {
@@ -216,10 +286,7 @@ static bool MDK_GetMetaData(const Info* info, mdkStringMapEntry* entry)
     auto abi = reinterpret_cast<const InfoAbi*>(info->priv);
     auto it = abi->metadata.cend();
     if (entry->priv) {
-        auto pit = (decltype(it)*)entry->priv;
-        it = *pit;
-        it++;
-        delete pit;
+        it = abi->metadata.upper_bound(*static_cast<const string*>(entry->priv));
     } else if (entry->key) {
         it = abi->metadata.find(entry->key);
     } else {
@@ -229,10 +296,27 @@ static bool MDK_GetMetaData(const Info* info, mdkStringMapEntry* entry)
         return false;
     entry->key = it->first.data();
     entry->value = it->second.data();
-    entry->priv = new decltype(it)(it);
+    entry->priv = (void*)&it->first;
     return true;
 }
 
+template<class InfoAbi, class Info>
+static int MDK_GetMetaDataAll(const Info* info, mdkStringMapEntry* out, int cap)
+{
+    if (!info)
+        return 0;
+    const auto& m = reinterpret_cast<const InfoAbi*>(info->priv)->metadata;
+    if (out) {
+        int i = 0;
+        for (auto it = m.cbegin(); it != m.cend() && i < cap; ++it, ++i) {
+            out[i].key = it->first.data();
+            out[i].value = it->second.data();
+            out[i].priv = (void*)&it->first;
+        }
+    }
+    return (int)m.size();
+}
+
 extern "C" {
 
 void MDK_AudioStreamCodecParameters(const mdkAudioStreamInfo* info, mdkAudioCodecParameters* p)
@@ -279,6 +363,31 @@ bool MDK_ProgramMetadata(const mdkProgramInfo* info, mdkStringMapEntry* entry)
     return MDK_GetMetaData<ProgramInfo>(info, entry);
 }
 
+int MDK_AudioStreamMetadataAll(const mdkAudioStreamInfo* info, mdkStringMapEntry* out, int cap)
+{
+    return MDK_GetMetaDataAll<AudioStreamInfo>(info, out, cap);
+}
+
+int MDK_VideoStreamMetadataAll(const mdkVideoStreamInfo* info, mdkStringMapEntry* out, int cap)
+{
+    return MDK_GetMetaDataAll<VideoStreamInfo>(info, out, cap);
+}
+
+int MDK_MediaMetadataAll(const mdkMediaInfo* info, mdkStringMapEntry* out, int cap)
+{
+    return MDK_GetMetaDataAll<MediaInfo>(info, out, cap);
+}
+
+int MDK_SubtitleStreamMetadataAll(const mdkSubtitleStreamInfo* info, mdkStringMapEntry* out, int cap)
+{
+    return MDK_GetMetaDataAll<SubtitleStreamInfo>(info, out, cap);
+}
+
+int MDK_ProgramMetadataAll(const mdkProgramInfo* info, mdkStringMapEntry* out, int cap)
+{
+    return MDK_GetMetaDataAll<ProgramInfo>(info, out, cap);
+}
+
 const uint8_t* MDK_VideoStreamData(const mdkVideoStreamInfo* info, int* len, int flags)
 {
     if (flags == 0) {
@@ -1,21 +1,23 @@
 /*
- * Copyright (c) 2019-2023 WangBin <wbsecg1 at gmail.com>
+ * Copyright (c) 2019-2026 WangBin <wbsecg1 at gmail.com>
  */
 #pragma once
 #include "mdk/c/MediaInfo.h"
 #include "mdk/MediaInfo.h"
+#include <cstddef>
+#include <memory>
 
 using namespace std;
 using namespace MDK_NS;
 
 struct MediaInfoInternal {
     MediaInfo abi;
-    mdkMediaInfo info;
-    vector<mdkChapterInfo> c;
-    vector<mdkAudioStreamInfo> a;
-    vector<mdkVideoStreamInfo> v;
-    vector<mdkSubtitleStreamInfo> s;
-    vector<mdkProgramInfo> p;
+    mdkMediaInfo info{};
+// chapters, programs, audio, video and subtitle arrays of info are placed in 1 buffer, and the buffer is reused by the next conversion if large enough
+    unique_ptr<max_align_t[]> arena;
+    size_t arena_size = 0; // in max_align_t
 };
 
 void MediaInfoToC(const MediaInfo& abi, MediaInfoInternal* out);
+// hash of MediaInfo fields exposed by C api except codec extra data and images. no copy and allocation
+uint64_t MediaInfoFingerprint(const MediaInfo& abi);
@@ -12,18 +12,39 @@
 #include "mdk/VideoFrame.h"
 #include "mdk/RenderAPI.h"
 #include "MediaInfoInternal.h"
+#include "FrameCache.h"
+#include "KeyframeIndex.h"
+#include "ReversePlayback.h"
+#include "TrickPlay.h"
+#include "FramePool.h"
+#include "BoundedQueue.h"
+#include "RingBuffer.h"
 #include <cassert>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
 #include <cstdlib>
 #include <cstring>
+#include <deque>
 #include <iostream>
+#include <mutex>
+#include <thread>
 
 using namespace std;
 using namespace MDK_NS;
 
-extern mdkAudioFrameAPI* MDK_AudioFrame_toC(const AudioFrame& frame);
+extern mdkAudioFrameAPI* MDK_AudioFrame_toC(const AudioFrame& frame, FramePool<mdkAudioFrame>* pool = nullptr);
 extern AudioFrame MDK_AudioFrame_fromC(mdkAudioFrameAPI* p);
-extern mdkVideoFrameAPI* MDK_VideoFrame_toC(const VideoFrame& frame);
+extern FramePool<mdkAudioFrame>* MDK_AudioFrame_newPool(int capacity);
+extern AudioFormat MDK_AudioFormat_fromC(MDK_SampleFormat format, int channels, int sampleRate);
+extern void MDK_AudioFrame_view(AudioFrame& frame, int track, void (*cb)(const mdkAudioFrameAPI*, int, void*), void* opaque);
+extern mdkVideoFrameAPI* MDK_VideoFrame_toC(const VideoFrame& frame, FramePool<mdkVideoFrame>* pool = nullptr);
 extern VideoFrame MDK_VideoFrame_fromC(mdkVideoFrameAPI* p);
+extern FramePool<mdkVideoFrame>* MDK_VideoFrame_newPool(int capacity);
+extern void MDK_VideoFrame_view(VideoFrame& frame, int track, void (*cb)(const mdkVideoFrameAPI*, int, void*), void* opaque);
+extern bool MDK_ProbeCache_enabled();
+extern shared_ptr<MediaInfo> MDK_ProbeCache_load(const char* url);
+extern void MDK_ProbeCache_store(const char* url, const MediaInfo& info);
 extern unique_ptr<RenderAPI> from_c(MDK_RenderAPI type, const void* data);
 extern ColorSpace kColorSpaceMap[];
 
@@ -37,10 +58,985 @@ static inline MediaType fromC(MDK_MediaType t)
     }
 }
 
+// strings are not copied
+static mdkMediaEvent MDK_MediaEvent_toC(const MediaEvent& e)
+{
+    mdkMediaEvent me{};
+    me.size = sizeof(me);
+    me.error = e.error;
+    me.category = e.category.data();
+    me.detail = e.detail.data();
+    me.decoder.stream = e.decoder.stream;
+    me.video.width = e.video.width;
+    me.video.height = e.video.height;
+    me.category_id = MDK_eventCategory(me.category);
+    me.detail_id = MDK_eventDetail(me.detail);
+    return me;
+}
+
+// collect frame handles and deliver them in 1 callback. pending frames are delivered by a timer thread if the next frame does not arrive in time
+// callback is invoked without holding the frame lock, so a slow callback does not block pushing. the callback can replace(destroy) the batch, the state is shared with the running push() and timer thread
+template<class FrameAPI, void (*Unref)(FrameAPI**)>
+class FrameBatch {
+public:
+    using Callback = void (*)(FrameAPI* const* frames, const int* tracks, int count, void* opaque);
+
+    FrameBatch(Callback cb, void* opaque, int maxFrames, int maxDelay)
+        : s_(make_shared<State>())
+    {
+        s_->cb = cb;
+        s_->opaque = opaque;
+        s_->max = std::max(maxFrames, 1);
+        s_->delay = maxDelay > 0 ? chrono::steady_clock::duration(chrono::milliseconds(maxDelay)) : chrono::steady_clock::duration::max();
+        s_->frames.reserve(s_->max);
+        s_->tracks.reserve(s_->max);
+        s_->delivering.reserve(s_->max);
+        s_->delivering_tracks.reserve(s_->max);
+        if (maxDelay > 0)
+            timer_ = thread([s = s_]{ run(s.get()); });
+    }
+
+    ~FrameBatch() { // pending frames are dropped if callback is removed
+        {
+            const lock_guard<mutex> lock(s_->mtx);
+            s_->stop = true;
+            s_->cv.notify_all();
+            for (auto& f : s_->frames)
+                Unref(&f);
+            s_->frames.clear();
+            s_->tracks.clear();
+        }
+        if (!timer_.joinable())
+            return;
+        // replaced in callback: can not join self, or the timer thread waiting for the callback. it exits later with its own state reference
+        const auto id = this_thread::get_id();
+        if (timer_.get_id() == id || s_->caller.load() == id)
+            timer_.detach();
+        else
+            timer_.join();
+    }
+
+    void push(FrameAPI* frame, int track, bool flush) {
+        const auto s = s_; // this batch can be destroyed in callback
+        const auto now = chrono::steady_clock::now();
+        {
+            const lock_guard<mutex> lock(s->mtx);
+            if (s->frames.empty()) {
+                s->first = now;
+                s->cv.notify_all(); // timer starts
+            }
+            if (frame) {
+                s->frames.push_back(frame);
+                s->tracks.push_back(track);
+            }
+            if (s->frames.empty())
+                return;
+            if (!flush && (int)s->frames.size() < s->max && now - s->first < s->delay)
+                return;
+        }
+        deliver(s.get());
+    }
+
+private:
+    struct State {
+        Callback cb = nullptr;
+        void* opaque = nullptr;
+        int max = 1;
+        chrono::steady_clock::duration delay;
+        chrono::steady_clock::time_point first;
+        mutex mtx; // frames, tracks, first, stop
+        condition_variable cv;
+        vector<FrameAPI*> frames;
+        vector<int> tracks;
+        bool stop = false;
+        mutex deliver_mtx; // batches are delivered in order and never concurrently
+        vector<FrameAPI*> delivering;
+        vector<int> delivering_tracks;
+        atomic<thread::id> caller; // thread in callback
+    };
+
+    static void deliver(State* s) {
+        const lock_guard<mutex> deliver_lock(s->deliver_mtx);
+        {
+            const lock_guard<mutex> lock(s->mtx);
+            if (s->stop || s->frames.empty()) // delivered by another thread
+                return;
+            s->frames.swap(s->delivering);
+            s->tracks.swap(s->delivering_tracks);
+        }
+        s->caller = this_thread::get_id();
+        s->cb(s->delivering.data(), s->delivering_tracks.data(), (int)s->delivering.size(), s->opaque);
+        s->caller = thread::id();
+        for (auto& f : s->delivering)
+            Unref(&f);
+        s->delivering.clear();
+        s->delivering_tracks.clear();
+    }
+// e.g. paused, stalled or a slow source
+    static void run(State* s) {
+        unique_lock<mutex> lock(s->mtx);
+        while (!s->stop) {
+            if (s->frames.empty())
+                s->cv.wait(lock);
+            else if (chrono::steady_clock::now() - s->first < s->delay)
+                s->cv.wait_until(lock, s->first + s->delay);
+            else {
+                lock.unlock();
+                deliver(s);
+                lock.lock();
+            }
+        }
+    }
+
+    const shared_ptr<State> s_;
+    thread timer_;
+};
+
+// bounded frame queue between decoder thread(producer) and user thread(consumer) for pull mode
+class VideoFrameQueue {
+public:
+    struct Entry {
+        VideoFrame frame;
+        int track = 0;
+    };
+
+    VideoFrameQueue(int capacity, MDK_FrameQueuePolicy policy)
+        : q_(std::max(capacity, 1))
+        , policy_(policy)
+    {}
+
+    void push(Entry&& e, const Player* player) {
+        while (!q_.push(std::move(e))) {
+            if (closed_.load(memory_order_relaxed))
+                return;
+            if (policy_ == MDK_FrameQueuePolicy_DropOldest) {
+                Entry old;
+                if (q_.pop(old))
+                    dropped_.fetch_add(1, memory_order_relaxed);
+                continue;
+            }
+            if (player->state() == State::Stopped) { // decoder thread must not be blocked to stop
+                dropped_.fetch_add(1, memory_order_relaxed);
+                return;
+            }
+            unique_lock<mutex> lock(mtx_);
+            full_waiters_.fetch_add(1);
+            not_full_.wait_for(lock, chrono::milliseconds(10), [this]{
+                return closed_.load(memory_order_relaxed) || q_.size() < q_.capacity();
+            });
+            full_waiters_.fetch_sub(1);
+        }
+        atomic_thread_fence(memory_order_seq_cst);
+        if (waiters_.load()) {
+            const lock_guard<mutex> lock(mtx_);
+            not_empty_.notify_one();
+        }
+    }
+
+    bool pop(Entry& e, int timeout) {
+        if (!tryPop(e) && timeout != 0) {
+            unique_lock<mutex> lock(mtx_);
+            waiters_.fetch_add(1);
+            const auto ready = [&]{ return closed_.load(memory_order_relaxed) || tryPop(e, true); };
+            if (timeout < 0)
+                not_empty_.wait(lock, ready);
+            else
+                not_empty_.wait_for(lock, chrono::milliseconds(timeout), ready);
+            waiters_.fetch_sub(1);
+        }
+        return !!e.frame || e.frame.timestamp() == TimestampEOS;
+    }
+
+    void close() {
+        closed_ = true;
+        const lock_guard<mutex> lock(mtx_);
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    int size() const { return (int)q_.size(); }
+    int64_t dropped() const { return dropped_.load(memory_order_relaxed); }
+
+private:
+    bool tryPop(Entry& e, bool locked = false) {
+        if (!q_.pop(e))
+            return false;
+        if (full_waiters_.load()) {
+            if (locked) {
+                not_full_.notify_one();
+            } else {
+                const lock_guard<mutex> lock(mtx_);
+                not_full_.notify_one();
+            }
+        }
+        return true;
+    }
+
+    BoundedQueue<Entry> q_;
+    const MDK_FrameQueuePolicy policy_;
+    atomic<bool> closed_ = false;
+    atomic<int> waiters_ = 0;
+    atomic<int> full_waiters_ = 0;
+    atomic<int64_t> dropped_ = 0;
+    mutex mtx_;
+    condition_variable not_empty_;
+    condition_variable not_full_;
+};
+
+// converted interleaved pcm from decoder thread(producer) to user thread(consumer) for pull mode
+class AudioReader {
+public:
+    AudioReader(MDK_SampleFormat format, int channels, int sampleRate, int frames)
+        : format_(MDK_AudioFormat_fromC(interleaved(format), channels, sampleRate))
+        , frame_bytes_(sampleBytes(format) * std::max(channels, 1))
+        , silence_(format == MDK_SampleFormat_U8 ? 0x80 : 0)
+        , ring_((size_t)std::max(frames, 1) * frame_bytes_)
+    {}
+
+    static MDK_SampleFormat interleaved(MDK_SampleFormat format) {
+        switch (format) {
+        case MDK_SampleFormat_U8P: return MDK_SampleFormat_U8;
+        case MDK_SampleFormat_S16P: return MDK_SampleFormat_S16;
+        case MDK_SampleFormat_S32P: return MDK_SampleFormat_S32;
+        case MDK_SampleFormat_F32P: return MDK_SampleFormat_F32;
+        case MDK_SampleFormat_F64P: return MDK_SampleFormat_F64;
+        default: return format;
+        }
+    }
+
+    static int sampleBytes(MDK_SampleFormat format) {
+        switch (format) {
+        case MDK_SampleFormat_U8:
+        case MDK_SampleFormat_U8P: return 1;
+        case MDK_SampleFormat_S16:
+        case MDK_SampleFormat_S16P: return 2;
+        case MDK_SampleFormat_F64:
+        case MDK_SampleFormat_F64P: return 8;
+        default: return 4;
+        }
+    }
+
+    void write(const AudioFrame& frame) {
+        if (!frame)
+            return;
+        const auto out = frame.to(format_);
+        const auto buf = out.buffer(0);
+        if (!buf)
+            return;
+        const auto bytes = std::min<size_t>(buf->size(), (size_t)out.samplesPerChannel() * frame_bytes_);
+        const auto room = (ring_.capacity() - ring_.size()) / frame_bytes_ * frame_bytes_;
+        if (room < bytes)
+            overruns_.fetch_add(1, memory_order_relaxed);
+        ring_.write(buf->constData(), std::min(bytes, room));
+    }
+
+    int read(uint8_t* dst, int frames) {
+        const size_t bytes = (size_t)std::max(frames, 0) * frame_bytes_;
+        const auto readable = ring_.size() / frame_bytes_ * frame_bytes_;
+        const auto n = ring_.read(dst, std::min(bytes, readable));
+        if (n < bytes) {
+            underruns_.fetch_add(1, memory_order_relaxed);
+            memset(dst + n, silence_, bytes - n);
+        }
+        return int(n / frame_bytes_);
+    }
+
+    int size() const { return int(ring_.size() / frame_bytes_); }
+    int64_t underruns() const { return underruns_.load(memory_order_relaxed); }
+    int64_t overruns() const { return overruns_.load(memory_order_relaxed); }
+
+private:
+    const AudioFormat format_;
+    const int frame_bytes_;
+    const uint8_t silence_;
+    RingBuffer ring_;
+    atomic<int64_t> underruns_ = 0;
+    atomic<int64_t> overruns_ = 0;
+};
+
+// events from any thread(producers) to user thread(consumer) for polling mode
+class EventQueue {
+public:
+    explicit EventQueue(int capacity)
+        : q_(std::max(capacity, 1))
+        , polled_(q_.capacity())
+    {}
+
+    void push(const MediaEvent& e) {
+        while (!q_.push(e)) { // drop the oldest
+            MediaEvent old;
+            if (q_.pop(old))
+                overflows_.fetch_add(1, memory_order_relaxed);
+        }
+    }
+// only 1 consumer thread. strings in out are valid until next poll
+    int poll(mdkMediaEvent* out, int max) {
+        const int n = std::min<int>(max, (int)polled_.size());
+        int i = 0;
+        for (; i < n; ++i) {
+            auto& e = polled_[i];
+            if (!q_.pop(e))
+                break;
+            out[i] = MDK_MediaEvent_toC(e);
+        }
+        return i;
+    }
+
+    int size() const { return (int)q_.size(); }
+    int64_t overflows() const { return overflows_.load(memory_order_relaxed); }
+
+private:
+    BoundedQueue<MediaEvent> q_;
+    vector<MediaEvent> polled_; // keep strings of polled events
+    atomic<int64_t> overflows_ = 0;
+};
+
+// seeks for scrubbing. only the latest request is pending, previous pending request is dropped
+class SeekCoalescer : public enable_shared_from_this<SeekCoalescer> {
+public:
+    void request(Player* player, int64_t pos, SeekFlag flags, mdkSeekCallback cb) {
+        mdkSeekCallback dropped{};
+        mdkSeekCallback abandoned{};
+        {
+            const lock_guard<mutex> lock(mtx_);
+            requests_++;
+            if (pending_.time.time_since_epoch().count()) {
+                dropped = pending_.cb;
+                coalesced_++;
+            }
+            pending_ = {pos, flags, cb, chrono::steady_clock::now()};
+            if (in_flight_ && !current_.abandoned && !(int(current_.flags) & int(SeekFlag::KeyFrame))) { // accurate seek is superseded
+                current_.abandoned = true;
+                abandoned = current_.cb;
+            }
+        }
+        if (dropped.opaque)
+            dropped.cb(-2, dropped.opaque);
+        if (abandoned.opaque)
+            abandoned.cb(-2, abandoned.opaque);
+        pump(player);
+    }
+
+    void close() {
+        const lock_guard<mutex> lock(mtx_);
+        closed_ = true;
+    }
+
+    void stats(mdkScrubStats* s) {
+        const lock_guard<mutex> lock(mtx_);
+        s->requests = requests_;
+        s->seeks = seeks_;
+        s->coalesced = coalesced_;
+        s->last_latency = last_latency_;
+        s->max_latency = max_latency_;
+        s->mean_latency = measured_ > 0 ? total_latency_ / measured_ : 0;
+    }
+
+private:
+    struct Request {
+        int64_t pos = 0;
+        SeekFlag flags = SeekFlag::Default;
+        mdkSeekCallback cb{};
+        chrono::steady_clock::time_point time{}; // 0: no request
+        bool abandoned = false; // superseded, result is not reported
+        uint64_t id = 0; // of a running seek
+    };
+
+    void pump(Player* player) {
+        for (;;) {
+            Request r;
+            {
+                const lock_guard<mutex> lock(mtx_);
+                if (closed_ || in_flight_ || !pending_.time.time_since_epoch().count())
+                    return;
+                r = current_ = pending_;
+                r.id = current_.id = ++seq_;
+                pending_ = {};
+                in_flight_ = true;
+                seeks_++;
+            }
+            // the core may invoke the callback of a rejected seek too, so a seek is finished only once, by the callback or by the rejection
+            if (player->seek(r.pos, r.flags, [self = shared_from_this(), player, id = r.id](int64_t ret){
+                self->finished(player, id, ret);
+            }))
+                return;
+            {
+                const lock_guard<mutex> lock(mtx_);
+                if (current_.id != r.id) // finished by callback in seek()
+                    return;
+                r = current_; // may be abandoned in seek()
+                current_ = {};
+                in_flight_ = false;
+            }
+            if (!r.abandoned && r.cb.opaque)
+                r.cb.cb(-1, r.cb.opaque);
+        }
+    }
+
+    void finished(Player* player, uint64_t id, int64_t ret) {
+        Request r;
+        {
+            const lock_guard<mutex> lock(mtx_);
+            if (current_.id != id) // rejected by seek()
+                return;
+            r = current_;
+            current_ = {};
+            in_flight_ = false;
+            if (!r.abandoned && ret >= 0) {
+                last_latency_ = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - r.time).count();
+                max_latency_ = std::max(max_latency_, last_latency_);
+                total_latency_ += last_latency_;
+                measured_++;
+            }
+        }
+        if (!r.abandoned && r.cb.opaque)
+            r.cb.cb(ret, r.cb.opaque);
+        pump(player);
+    }
+
+    mutex mtx_;
+    Request pending_;
+    Request current_;
+    bool in_flight_ = false;
+    bool closed_ = false;
+    uint64_t seq_ = 0;
+    int64_t requests_ = 0;
+    int64_t seeks_ = 0;
+    int64_t coalesced_ = 0;
+    int64_t last_latency_ = 0;
+    int64_t max_latency_ = 0;
+    int64_t total_latency_ = 0;
+    int64_t measured_ = 0;
+};
+
+/*
+  Measures loop transition gap by video frames delivered by decoder: the interval between the last frame before loop point and the 1st frame after it,
+  minus the interval of 2 continuous frames before loop point.
+ */
+class LoopMonitor {
+public:
+    using Callback = function<void(int count, int64_t gap)>;
+
+    void loop(int count, Callback cb) {
+        vector<Pending> stale; // no frame since the previous loop
+        {
+            const lock_guard<mutex> lock(mtx_);
+            if (!pending_.empty() && pending_.back().count != count)
+                stale.swap(pending_);
+            pending_.push_back({count, std::move(cb)});
+        }
+        for (const auto& p : stale)
+            p.cb(p.count, -1);
+    }
+
+    void frame(const VideoFrame& frame) {
+        const auto t = frame.timestamp();
+        if (!frame || t < 0 || t == TimestampEOS)
+            return;
+        const auto now = chrono::steady_clock::now();
+        vector<Pending> ready;
+        int64_t gap = 0;
+        {
+            const lock_guard<mutex> lock(mtx_);
+            const auto elapsed = now - last_time_;
+            if (last_t_ >= 0 && t < last_t_) { // back to loop point
+                gap = std::max<int64_t>(0, chrono::duration_cast<chrono::milliseconds>(elapsed - interval_).count());
+                ready.swap(pending_);
+            } else if (last_t_ >= 0) {
+                interval_ = elapsed;
+            }
+            last_t_ = t;
+            last_time_ = now;
+        }
+        for (const auto& p : ready)
+            p.cb(p.count, gap);
+    }
+
+private:
+    struct Pending {
+        int count;
+        Callback cb;
+    };
+
+    mutex mtx_;
+    vector<Pending> pending_;
+    double last_t_ = -1;
+    chrono::steady_clock::time_point last_time_;
+    chrono::steady_clock::duration interval_{};
+};
+
 struct mdkPlayer : Player{
+    mdkPlayer() {
+        addMediaInfoCallbacks();
+    }
+
+    ~mdkPlayer() {
+        video_pool->release();
+        audio_pool->release();
+    }
+
     MediaInfoInternal media_info;
+    uint64_t media_info_hash = 0;
+    int64_t media_info_gen = 0; // 0: not converted
+    // increased when media info may be changed: media status changes, decoder and metadata events, setMedia() and probe cache. captured by callbacks
+    const shared_ptr<atomic<int64_t>> media_info_changes = make_shared<atomic<int64_t>>(1);
+    int64_t media_info_checked = 0; // media_info_changes of the last check
+    const shared_ptr<atomic<bool>> alive = make_shared<atomic<bool>>(true); // false if reset for destruction. captured by deferred seeks
+    FramePool<mdkVideoFrame>* video_pool = MDK_VideoFrame_newPool(8); // handles for onVideo callback
+    FramePool<mdkAudioFrame>* audio_pool = MDK_AudioFrame_newPool(8); // handles for onAudio callback
+
+    shared_ptr<VideoFrameQueue> videoQueue() {
+        const lock_guard<mutex> lock(queue_mtx);
+        return video_queue;
+    }
+
+    void setVideoQueue(shared_ptr<VideoFrameQueue> q) {
+        const lock_guard<mutex> lock(queue_mtx);
+        if (video_queue)
+            video_queue->close();
+        video_queue = std::move(q);
+    }
+
+// the only video frame callback of core is shared by user callbacks and frame cache
+    void onVideoFrame(function<int(VideoFrame&, int)> cb) {
+        const lock_guard<mutex> lock(queue_mtx);
+        video_cb = std::move(cb);
+        installVideoCallback();
+    }
+
+    shared_ptr<FrameCache> frameCache() {
+        const lock_guard<mutex> lock(queue_mtx);
+        return frame_cache;
+    }
+
+    void setFrameCache(shared_ptr<FrameCache> c) {
+        const lock_guard<mutex> lock(queue_mtx);
+        frame_cache = std::move(c);
+        installVideoCallback();
+    }
+
+    shared_ptr<LoopMonitor> loopMonitor() {
+        const lock_guard<mutex> lock(queue_mtx);
+        return loop_monitor;
+    }
+
+    void setLoopMonitor(shared_ptr<LoopMonitor> m) {
+        const lock_guard<mutex> lock(queue_mtx);
+        loop_monitor = std::move(m);
+        loop_tokens.clear();
+        installVideoCallback();
+    }
+
+// loop callbacks measuring gap share the monitor, which is removed with the last of them
+    void addLoopCallback(shared_ptr<LoopMonitor> m, const CallbackToken* token) {
+        const lock_guard<mutex> lock(queue_mtx);
+        loop_tokens.push_back(token ? *token : 0);
+        if (loop_monitor)
+            return;
+        loop_monitor = std::move(m);
+        installVideoCallback();
+    }
+// null token: all loop callbacks are removed
+    void removeLoopCallback(const CallbackToken* token) {
+        const lock_guard<mutex> lock(queue_mtx);
+        if (token)
+            erase(loop_tokens, *token);
+        else
+            loop_tokens.clear();
+        if (!loop_tokens.empty() || !loop_monitor)
+            return;
+        loop_monitor.reset();
+        installVideoCallback();
+    }
+
+    shared_ptr<ReversePlayback> reversePlayback() {
+        const lock_guard<mutex> lock(queue_mtx);
+        return reverse;
+    }
+
+    void setReversePlayback(shared_ptr<ReversePlayback> r) {
+        {
+            const lock_guard<mutex> lock(queue_mtx);
+            reverse.swap(r);
+        }
+        r.reset(); // stop old threads out of lock
+    }
+
+    shared_ptr<TrickPlay> trickPlay() {
+        const lock_guard<mutex> lock(queue_mtx);
+        return trick;
+    }
+
+    void setTrickPlay(shared_ptr<TrickPlay> t) {
+        {
+            const lock_guard<mutex> lock(queue_mtx);
+            trick.swap(t);
+        }
+        t.reset(); // stop old thread out of lock
+    }
+
+    shared_ptr<AudioReader> audioReader() {
+        const lock_guard<mutex> lock(queue_mtx);
+        return audio_reader;
+    }
+
+    void setAudioReader(shared_ptr<AudioReader> r) {
+        const lock_guard<mutex> lock(queue_mtx);
+        audio_reader = std::move(r);
+    }
+
+    shared_ptr<EventQueue> eventQueue() {
+        const lock_guard<mutex> lock(queue_mtx);
+        return event_queue;
+    }
+// the queue is captured by an internal event callback, so producers never lock
+    void setEventQueue(shared_ptr<EventQueue> q) {
+        const lock_guard<mutex> lock(queue_mtx);
+        if (event_token)
+            onEvent(nullptr, &event_token);
+        event_token = 0;
+        event_queue = std::move(q);
+        addEventQueueCallback();
+    }
+// all event callbacks are removed by user
+    void resetEventQueueCallback() {
+        const lock_guard<mutex> lock(queue_mtx);
+        event_token = 0;
+        addEventQueueCallback();
+    }
+
+// media info from probe cache, valid until current media is changed
+    shared_ptr<const MediaInfo> cachedMediaInfo() {
+        const lock_guard<mutex> lock(cache_mtx);
+        if (!cached_info)
+            return nullptr;
+        const auto u = url();
+        if (!u || cached_url != u)
+            return nullptr;
+        return cached_info;
+    }
+
+    void setCachedMediaInfo(shared_ptr<const MediaInfo> info) {
+        const auto u = url();
+        {
+            const lock_guard<mutex> lock(cache_mtx);
+            cached_info = std::move(info);
+            cached_url = u ? u : "";
+        }
+        mediaInfoMayChange();
+    }
+
+    void mediaInfoMayChange() {
+        media_info_changes->fetch_add(1, memory_order_release);
+    }
+// media status and event callbacks to detect media info changes. called again if all callbacks of the type are removed by user
+    void addMediaInfoCallbacks(bool status = true, bool event = true) {
+        if (status) {
+            onMediaStatus([c = media_info_changes](MediaStatus, MediaStatus){
+                c->fetch_add(1, memory_order_release);
+                return true;
+            }, &media_info_status_token);
+        }
+        if (event) {
+            onEvent([c = media_info_changes](const MediaEvent& e){
+                if (e.category == "metadata" || e.category.starts_with("decoder."))
+                    c->fetch_add(1, memory_order_release);
+                return false;
+            }, &media_info_event_token);
+        }
+    }
+
+// index of current media, or null if disabled
+    shared_ptr<KeyframeIndex> keyframeIndex() {
+        shared_ptr<KeyframeIndex> old; // destroyed after unlock, it joins background pass
+        const lock_guard<mutex> lock(cache_mtx);
+        if (!keyframe_index_enabled)
+            return nullptr;
+        const auto u = url();
+        if (!u || !*u)
+            return nullptr;
+        if (!keyframe_index || keyframe_index->url() != u) {
+            old = std::move(keyframe_index);
+            keyframe_index = make_shared<KeyframeIndex>(u);
+            if (keyframe_index_background)
+                keyframe_index->build();
+        }
+        return keyframe_index;
+    }
+
+    void setKeyframeIndex(bool enable, bool background) {
+        shared_ptr<KeyframeIndex> old;
+        {
+            const lock_guard<mutex> lock(cache_mtx);
+            keyframe_index_enabled = enable;
+            keyframe_index_background = background;
+            if (!enable)
+                old = std::move(keyframe_index); // stop background pass out of lock
+        }
+        if (auto index = keyframeIndex(); index && background)
+            index->build();
+    }
+
+    mutex cache_mtx;
+    shared_ptr<const MediaInfo> cached_info;
+    string cached_url;
+    shared_ptr<KeyframeIndex> keyframe_index; // captured by seek callbacks
+    bool keyframe_index_enabled = false;
+    bool keyframe_index_background = false;
+
+    mutex queue_mtx;
+    shared_ptr<VideoFrameQueue> video_queue; // pull mode
+    shared_ptr<AudioReader> audio_reader; // pull mode
+    shared_ptr<EventQueue> event_queue; // polling mode
+    function<int(VideoFrame&, int)> video_cb;
+    shared_ptr<FrameCache> frame_cache;
+    shared_ptr<LoopMonitor> loop_monitor;
+    vector<CallbackToken> loop_tokens; // of loop callbacks using loop_monitor, 0 if added without token
+    bool loop_cache = false;
+    string loop_cache_ranges; // properties before loop cache is enabled
+    string loop_cache_protocols;
+    shared_ptr<ReversePlayback> reverse;
+    float reverse_rate = 0; // < 0: reverse playback is enabled
+    int64_t reverse_budget = 256 << 20;
+    MDK_ReverseDropPolicy reverse_policy = MDK_ReverseDropPolicy_Wait;
+    shared_ptr<TrickPlay> trick;
+    float trick_rate = 0; // > 0: key frame only playback is enabled
+    float trick_threshold = 0;
+    int trick_interval = 100;
+    CallbackToken event_token = 0;
+    CallbackToken media_info_status_token = 0;
+    CallbackToken media_info_event_token = 0;
+    atomic<int> audio_read_track = 0; // the 1st active audio track, the only one written to audio reader
+    const shared_ptr<SeekCoalescer> scrubber = make_shared<SeekCoalescer>(); // captured by seek callbacks
+
+private:
+    void installVideoCallback() {
+        if (!frame_cache && !loop_monitor) {
+            if (video_cb)
+                onFrame<VideoFrame>(video_cb);
+            else
+                onFrame<VideoFrame>(nullptr);
+            return;
+        }
+        onFrame<VideoFrame>([c = frame_cache, m = loop_monitor, cb = video_cb](VideoFrame& frame, int track){
+            const auto ret = cb ? cb(frame, track) : 0;
+            if (c)
+                c->add(frame); // the frame to be rendered
+            if (m)
+                m->frame(frame);
+            return ret;
+        });
+    }
+
+    void addEventQueueCallback() {
+        if (!event_queue)
+            return;
+        onEvent([q = event_queue](const MediaEvent& e){
+            q->push(e);
+            return false;
+        }, &event_token);
+    }
 };
 
+// destroys players in a background thread. the thread exits when no pending player
+class PlayerReaper {
+public:
+    static PlayerReaper& instance() {
+        static auto r = new PlayerReaper(); // never destroyed because the detached thread may still use it
+        return *r;
+    }
+
+    void push(const mdkPlayerAPI* api, mdkPlayerDeletedCallback cb) {
+        const lock_guard<mutex> lock(mtx_);
+        jobs_.push_back({api, cb});
+        pending_++;
+        if (running_)
+            return;
+        running_ = true;
+        thread([this]{ run(); }).detach();
+    }
+
+    int pending() const { return pending_.load(memory_order_relaxed); }
+
+private:
+    struct Job {
+        const mdkPlayerAPI* api;
+        mdkPlayerDeletedCallback cb;
+    };
+
+    void run() {
+        unique_lock<mutex> lock(mtx_);
+        while (!jobs_.empty()) {
+            const auto job = jobs_.front();
+            jobs_.pop_front();
+            lock.unlock();
+            delete job.api->object;
+            delete job.api;
+            pending_--;
+            if (job.cb.opaque)
+                job.cb.cb(job.cb.opaque);
+            lock.lock();
+        }
+        running_ = false;
+    }
+
+    mutex mtx_;
+    deque<Job> jobs_;
+    bool running_ = false;
+    atomic<int> pending_ = 0;
+};
+
+// position of the frame presented by reverse playback or frame cache, or decoder position
+static int64_t currentPosition(mdkPlayer* p)
+{
+    if (auto r = p->reversePlayback())
+        return (int64_t)llround(r->position() * 1000.0) - p->mediaInfo().start_time;
+    if (auto t = p->trickPlay())
+        return t->position();
+    if (auto c = p->frameCache()) {
+        if (const auto t = c->cursor(); t >= 0)
+            return (int64_t)llround(t * 1000.0) - p->mediaInfo().start_time;
+    }
+    return p->position();
+}
+
+static void startReverse(mdkPlayer* p, int64_t pos)
+{
+    const auto start = p->mediaInfo().start_time;
+    if (auto c = p->frameCache())
+        c->attach();
+    p->set(State::Paused);
+    const auto url = p->url();
+    p->setReversePlayback(make_shared<ReversePlayback>(p, url ? url : "", start, double(pos + start) / 1000.0, -p->reverse_rate, p->reverse_budget, p->reverse_policy));
+}
+
+// decoder seeks to the last presented frame if sync is true
+static bool stopReverse(mdkPlayer* p, bool sync)
+{
+    auto r = p->reversePlayback();
+    if (!r)
+        return false;
+    const auto t = r->position();
+    r.reset();
+    p->setReversePlayback(nullptr);
+    if (sync)
+        p->seek((int64_t)llround(t * 1000.0), SeekFlag::From0, nullptr);
+    return true;
+}
+
+// enable demuxer packet cache for protocol of url
+static void addCacheProtocol(mdkPlayer* p, const char* url)
+{
+    if (!url || !*url)
+        return;
+    const string_view u(url);
+    const auto colon = u.find("://");
+    const auto scheme = string(colon == string_view::npos || colon < 2 ? "file" : u.substr(0, colon)); // 1 letter: windows drive
+    auto protocols = p->property("demux.buffer.protocols", "http,https");
+    if (("," + protocols + ",").find("," + scheme + ",") != string::npos)
+        return;
+    if (!protocols.empty())
+        protocols += ',';
+    p->setProperty("demux.buffer.protocols", protocols + scheme);
+}
+
+static void startTrickPlay(mdkPlayer* p, int64_t pos)
+{
+    if (auto c = p->frameCache())
+        c->attach();
+    p->set(State::Paused);
+    p->setTrickPlay(make_shared<TrickPlay>(p, pos, p->mediaInfo().duration, p->trick_rate, p->trick_interval));
+}
+
+// decoder seeks to the virtual clock accurately if sync is true, after the running key frame seek.
+// returns the stopped trick play, or null if not running. a seek after it should be deferred by TrickPlay::defer()
+static shared_ptr<TrickPlay> stopTrickPlay(mdkPlayer* p, bool sync)
+{
+    auto t = p->trickPlay();
+    if (!t)
+        return nullptr;
+    const auto pos = t->syncPosition();
+    p->setTrickPlay(nullptr);
+    t->stop();
+    if (sync) {
+        const auto seek = [p, pos, alive = p->alive]{
+            if (alive->load())
+                p->seek(pos, SeekFlag::FromStart, nullptr);
+        };
+        if (!t->defer(seek))
+            seek();
+    }
+    return t;
+}
+
+// present a cached frame for frame steps and accurate seeks if possible. pos and flags are changed to seek from the presented frame if not
+static bool seekFrameCache(mdkPlayer* p, FrameCache& c, int64_t& pos, MDK_SeekFlag& flags, mdkSeekCallback cb)
+{
+    const auto start = p->mediaInfo().start_time;
+    VideoFrame frame;
+    int64_t ms = 0;
+    bool hit = false;
+    if ((flags & MDK_SeekFlag_Frame) && (flags & MDK_SeekFlag_FromNow)) {
+        if (pos < 0 || c.stepping()) { // in order, and the previous gop is decoded and cached if missed
+            const auto url = p->url();
+            c.stepAsync((int)pos, url ? url : "", start, [p, n = pos, start, cb](const VideoFrame& frame, int64_t ms){
+                if (frame) {
+                    p->enqueue(frame, nullptr);
+                    if (cb.opaque)
+                        cb.cb(ms - start, cb.opaque);
+                    return;
+                }
+                if (ms == -2) { // media changed
+                    if (cb.opaque)
+                        cb.cb(-2, cb.opaque);
+                    return;
+                }
+                p->seek(ms >= 0 ? ms : n, ms >= 0 ? SeekFlag::From0 : SeekFlag(int(SeekFlag::FromNow) | int(SeekFlag::Frame)), [cb](int64_t ret){
+                    if (cb.opaque)
+                        cb.cb(ret, cb.opaque);
+                });
+            });
+            return true;
+        }
+        if (c.detached()) // forward steps from decoder position never hit
+            hit = c.step((int)pos, frame, ms);
+        if (!hit && c.detached()) { // decoder position is not the presented frame
+            pos = (int64_t)llround(c.target((int)pos) * 1000.0);
+            flags = MDK_SeekFlag_From0;
+        }
+    } else if (!(flags & MDK_SeekFlag_KeyFrame) && (flags & (MDK_SeekFlag_From0 | MDK_SeekFlag_FromStart))) { // e.g. short back-scrubs
+        hit = c.at(double((flags & MDK_SeekFlag_FromStart) ? pos + start : pos) / 1000.0, frame, ms);
+    }
+    if (!hit)
+        return false;
+    p->enqueue(frame, nullptr);
+    if (cb.opaque)
+        cb.cb(ms - start, cb.opaque);
+    return true;
+}
+
+// callbacks and features set by user. the player can be reused for another media
+void MDK_Player_resetCallbacks(mdkPlayer* p)
+{
+    p->setReversePlayback(nullptr); // stop presenting frames
+    p->setTrickPlay(nullptr);
+    p->setRenderCallback(nullptr);
+    p->onMediaStatus(nullptr);
+    p->onStateChanged(nullptr);
+    p->setEventQueue(nullptr);
+    p->onEvent(nullptr);
+    p->addMediaInfoCallbacks(); // the player may be reused
+    p->onVideoFrame(nullptr);
+    p->setFrameCache(nullptr);
+    p->setLoopMonitor(nullptr);
+    p->onFrame<AudioFrame>(nullptr);
+    p->setTimeout(0, nullptr);
+    p->onLoop(nullptr);
+    p->onSync(nullptr);
+    p->setVideoQueue(nullptr); // wake up consumers waiting in acquireVideoFrame()
+    p->setKeyframeIndex(false, false); // stop background pass
+}
+
 extern "C" {
 
 void MDK_Player_setMute(mdkPlayer* p, bool value)
@@ -60,12 +1056,20 @@ void MDK_Player_setChannelVolume(mdkPlayer* p, float value, int channel)
 
 void MDK_Player_setMedia(mdkPlayer* p, const char* url)
 {
+    if (p->loop_cache)
+        addCacheProtocol(p, url);
+    stopReverse(p, false);
+    stopTrickPlay(p, false);
+    if (auto c = p->frameCache())
+        c->clear();
     p->setMedia(url);
+    p->mediaInfoMayChange();
 }
 
 void MDK_Player_setMediaForType(mdkPlayer* p, const char* url, MDK_MediaType type)
 {
     p->setMedia(url, fromC(type));
+    p->mediaInfoMayChange();
 }
 
 const char* MDK_Player_url(mdkPlayer* p)
@@ -139,28 +1143,89 @@ void MDK_Player_setTimeout(mdkPlayer* p, int64_t value, mdkTimeoutCallback cb)
 
 void MDK_Player_prepare(mdkPlayer* p, int64_t startPosition, mdkPrepareCallback cb, MDKSeekFlag flag)
 {
-    if (!cb.opaque) {
+    stopReverse(p, false);
+    stopTrickPlay(p, false);
+    if (auto c = p->frameCache())
+        c->attach();
+    // only mediaInfo() is served from cache until the media is loaded, cb is invoked once with the real result as usual
+    auto info = MDK_ProbeCache_load(p->url());
+    const bool store = !info && MDK_ProbeCache_enabled(); // a hit is the same file, no need to rewrite
+    if (info)
+        p->setCachedMediaInfo(std::move(info));
+    if (!cb.opaque && !store) {
         p->prepare(startPosition, nullptr, SeekFlag(flag));
         return;
     }
-    p->prepare(startPosition, [cb](int64_t position, bool* boost){
+    p->prepare(startPosition, [cb, store, p](int64_t position, bool* boost){
+        if (store && position >= 0)
+            MDK_ProbeCache_store(p->url(), p->mediaInfo());
+        if (!cb.opaque)
+            return true;
         return cb.cb(position, boost, cb.opaque);
     }, SeekFlag(flag));
 }
 
+// convert only if changed
+static void MDK_Player_updateMediaInfo(mdkPlayer* p)
+{
+    const auto changes = p->media_info_changes->load(memory_order_acquire);
+    if (changes == p->media_info_checked && p->media_info_gen > 0) // no status change or event since the last check
+        return;
+    p->media_info_checked = changes;
+    const auto cached = p->cachedMediaInfo();
+    const auto& loaded = p->mediaInfo();
+    const auto& info = cached && loaded.streams == 0 ? *cached : loaded; // cached until loaded
+    const auto h = MediaInfoFingerprint(info);
+    if (h == p->media_info_hash && p->media_info_gen > 0)
+        return;
+    MediaInfoToC(info, &p->media_info);
+    p->media_info_hash = h;
+    p->media_info_gen++;
+}
+
 const mdkMediaInfo* MDK_Player_mediaInfo(mdkPlayer* p)
 {
-    MediaInfoToC(p->mediaInfo(), &p->media_info);
+    MDK_Player_updateMediaInfo(p);
     return &p->media_info.info;
 }
 
+bool MDK_Player_mediaInfoChanged(mdkPlayer* p, int64_t* generation)
+{
+    MDK_Player_updateMediaInfo(p);
+    if (!generation)
+        return true;
+    const bool changed = *generation != p->media_info_gen;
+    *generation = p->media_info_gen;
+    return changed;
+}
+
 void MDK_Player_setState(mdkPlayer* p, MDK_State value)
 {
+    if (value == MDK_State_Playing && p->reverse_rate < 0) {
+        if (!p->reversePlayback())
+            startReverse(p, currentPosition(p));
+        return;
+    }
+    if (value == MDK_State_Playing && p->trick_rate > 0) {
+        if (!p->trickPlay())
+            startTrickPlay(p, currentPosition(p));
+        return;
+    }
+    stopReverse(p, value == MDK_State_Paused);
+    stopTrickPlay(p, value == MDK_State_Paused);
+    if (auto c = p->frameCache(); c && value == MDK_State_Playing) {
+        if (const auto t = c->cursor(); t >= 0) { // resume from the frame presented from cache
+            p->seek((int64_t)llround(t * 1000.0), SeekFlag::From0, nullptr);
+            c->attach();
+        }
+    }
     p->set(State(value));
 }
 
 MDK_State MDK_Player_state(mdkPlayer* p)
 {
+    if (p->reversePlayback() || p->trickPlay())
+        return MDK_State_Playing;
     return (MDK_State)p->state();
 }
 
@@ -189,6 +1254,7 @@ void MDK_Player_onMediaStatusChanged(mdkPlayer* p, mdkMediaStatusChangedCallback
 {
     if (!cb.opaque) {
         p->onMediaStatus(nullptr);
+        p->addMediaInfoCallbacks(true, false);
         return;
     }
     p->onMediaStatus([cb](MediaStatus old, MediaStatus value){
@@ -200,6 +1266,8 @@ void MDK_Player_onMediaStatus(mdkPlayer* p, mdkMediaStatusCallback cb, MDK_Callb
 {
     if (!cb.opaque) {
         p->onMediaStatus(nullptr, token);
+        if (!token)
+            p->addMediaInfoCallbacks(true, false);
         return;
     }
     p->onMediaStatus([cb](MediaStatus old, MediaStatus value){
@@ -288,11 +1356,11 @@ void MDK_Player_setRenderCallback(mdkPlayer* p, mdkRenderCallback cb)
 void MDK_Player_onVideo(mdkPlayer* p, mdkVideoCallback cb)
 {
     if (!cb.opaque) {
-        p->onFrame<VideoFrame>(nullptr);
+        p->onVideoFrame(nullptr);
         return;
     }
-    p->onFrame<VideoFrame>([cb](VideoFrame& frame, int track){
-        auto f = MDK_VideoFrame_toC(frame);
+    p->onVideoFrame([cb, p](VideoFrame& frame, int track){
+        auto f = MDK_VideoFrame_toC(frame, p->video_pool);
         auto f0 = f;
         auto ret = cb.cb(&f, track, cb.opaque);
         if (f != f0) {
@@ -310,8 +1378,8 @@ void MDK_Player_onAudio(mdkPlayer* p, mdkAudioCallback cb)
         p->onFrame<AudioFrame>(nullptr);
         return;
     }
-    p->onFrame<AudioFrame>([cb](AudioFrame& frame, int track){
-        auto f = MDK_AudioFrame_toC(frame);
+    p->onFrame<AudioFrame>([cb, p](AudioFrame& frame, int track){
+        auto f = MDK_AudioFrame_toC(frame, p->audio_pool);
         auto f0 = f;
         auto ret = cb.cb(&f, track, cb.opaque);
         if (f != f0) {
@@ -323,13 +1391,173 @@ void MDK_Player_onAudio(mdkPlayer* p, mdkAudioCallback cb)
     });
 }
 
+void MDK_Player_onVideoView(mdkPlayer* p, mdkVideoViewCallback cb)
+{
+    if (!cb.opaque) {
+        p->onVideoFrame(nullptr);
+        return;
+    }
+    p->onVideoFrame([cb](VideoFrame& frame, int track){
+        MDK_VideoFrame_view(frame, track, cb.cb, cb.opaque);
+        return 0;
+    });
+}
+
+void MDK_Player_onAudioView(mdkPlayer* p, mdkAudioViewCallback cb)
+{
+    if (!cb.opaque) {
+        p->onFrame<AudioFrame>(nullptr);
+        return;
+    }
+    p->onFrame<AudioFrame>([cb](AudioFrame& frame, int track){
+        MDK_AudioFrame_view(frame, track, cb.cb, cb.opaque);
+        return 0;
+    });
+}
+
+void MDK_Player_onVideoBatch(mdkPlayer* p, mdkVideoBatchCallback cb, int maxFrames, int maxDelay)
+{
+    if (!cb.opaque) {
+        p->onVideoFrame(nullptr);
+        return;
+    }
+    auto batch = make_shared<FrameBatch<mdkVideoFrameAPI, mdkVideoFrameAPI_unref>>(cb.cb, cb.opaque, maxFrames, maxDelay);
+    p->onVideoFrame([batch, p](VideoFrame& frame, int track){
+        batch->push(MDK_VideoFrame_toC(frame, p->video_pool), track, frame.timestamp() == TimestampEOS);
+        return 0;
+    });
+}
+
+void MDK_Player_onAudioBatch(mdkPlayer* p, mdkAudioBatchCallback cb, int maxFrames, int maxDelay)
+{
+    if (!cb.opaque) {
+        p->onFrame<AudioFrame>(nullptr);
+        return;
+    }
+    auto batch = make_shared<FrameBatch<mdkAudioFrameAPI, mdkAudioFrameAPI_unref>>(cb.cb, cb.opaque, maxFrames, maxDelay);
+    p->onFrame<AudioFrame>([batch, p](AudioFrame& frame, int track){
+        batch->push(MDK_AudioFrame_toC(frame, p->audio_pool), track, frame.timestamp() == TimestampEOS);
+        return 0;
+    });
+}
+
+void MDK_Player_setVideoFrameQueue(mdkPlayer* p, int capacity, MDK_FrameQueuePolicy policy)
+{
+    if (capacity <= 0) {
+        p->onVideoFrame(nullptr);
+        p->setVideoQueue(nullptr);
+        return;
+    }
+    auto q = make_shared<VideoFrameQueue>(capacity, policy);
+    p->setVideoQueue(q);
+    p->onVideoFrame([q, p](VideoFrame& frame, int track){
+        q->push({frame, track}, p);
+        return 0;
+    });
+}
+
+mdkVideoFrameAPI* MDK_Player_acquireVideoFrame(mdkPlayer* p, int timeout, int* track)
+{
+    auto q = p->videoQueue();
+    if (!q)
+        return nullptr;
+    VideoFrameQueue::Entry e;
+    if (!q->pop(e, timeout))
+        return nullptr;
+    if (track)
+        *track = e.track;
+    return MDK_VideoFrame_toC(e.frame, p->video_pool);
+}
+
+void MDK_Player_releaseVideoFrame(mdkPlayer*, mdkVideoFrameAPI** frame)
+{
+    mdkVideoFrameAPI_unref(frame);
+}
+
+int MDK_Player_videoFrameQueueSize(mdkPlayer* p, int64_t* dropped)
+{
+    auto q = p->videoQueue();
+    if (dropped)
+        *dropped = q ? q->dropped() : 0;
+    return q ? q->size() : 0;
+}
+
+void MDK_Player_setAudioReadBuffer(mdkPlayer* p, MDK_SampleFormat format, int channels, int sampleRate, int frames)
+{
+    if (frames <= 0) {
+        p->onFrame<AudioFrame>(nullptr);
+        p->setAudioReader(nullptr);
+        return;
+    }
+    auto r = make_shared<AudioReader>(format, channels, sampleRate, frames);
+    p->setAudioReader(r);
+    p->onFrame<AudioFrame>([r, p](AudioFrame& frame, int track){
+        if (track == p->audio_read_track.load(memory_order_relaxed)) // pcm of multiple tracks can not be mixed in 1 buffer
+            r->write(frame);
+        return 0;
+    });
+}
+
+int MDK_Player_readAudio(mdkPlayer* p, void* dst, int frames)
+{
+    auto r = p->audioReader();
+    if (!r)
+        return 0;
+    return r->read((uint8_t*)dst, frames);
+}
+
+int MDK_Player_audioReadBufferSize(mdkPlayer* p, int64_t* underruns, int64_t* overruns)
+{
+    auto r = p->audioReader();
+    if (underruns)
+        *underruns = r ? r->underruns() : 0;
+    if (overruns)
+        *overruns = r ? r->overruns() : 0;
+    return r ? r->size() : 0;
+}
+
 int64_t MDK_Player_position(mdkPlayer* p)
 {
-    return p->position();
+    return currentPosition(p);
 }
 
 bool MDK_Player_seekWithFlags(mdkPlayer* p, int64_t pos, MDK_SeekFlag flags, mdkSeekCallback cb)
 {
+    const auto now = currentPosition(p);
+    const bool reversing = stopReverse(p, false);
+    const auto trick = stopTrickPlay(p, false);
+    if ((reversing || trick) && (flags & MDK_SeekFlag_FromNow)) { // relative to the presented frame. the core skips a seek if the previous one is unfinished, so no extra sync seek
+        if (flags & MDK_SeekFlag_Frame) {
+            const auto& v = p->mediaInfo().video;
+            const double fps = v.empty() || v[0].codec.frame_rate <= 0 ? 25.0 : v[0].codec.frame_rate;
+            pos = (int64_t)llround(double(pos) * 1000.0 / fps);
+        }
+        pos += now;
+        flags = MDK_SeekFlag((flags & ~(MDK_SeekFlag_From0 | MDK_SeekFlag_FromNow | MDK_SeekFlag_Frame)) | MDK_SeekFlag_FromStart);
+    }
+    if (trick && trick->defer([p, pos, flags, cb, alive = p->alive]{
+            if (alive->load())
+                MDK_Player_seekWithFlags(p, pos, flags, cb);
+        }))
+        return true;
+    if (auto c = p->frameCache()) {
+        if (p->state() != State::Playing && seekFrameCache(p, *c, pos, flags, cb))
+            return true;
+        c->attach();
+    }
+    if (auto index = p->keyframeIndex(); index && (flags & MDK_SeekFlag_KeyFrame)) {
+        int64_t k = 0;
+        if ((flags & MDK_SeekFlag_Backward) && (flags & MDK_SeekFlag_FromStart) && index->floor(pos, k)) { // exact key frame, no backward search
+            pos = k;
+            flags = MDK_SeekFlag(flags & ~MDK_SeekFlag_Backward);
+        }
+        return p->seek(pos, SeekFlag(flags), [cb, index](int64_t value){
+            if (value >= 0)
+                index->add(value);
+            if (cb.opaque)
+                cb.cb(value, cb.opaque);
+        });
+    }
     if (!cb.opaque) {
         return p->seek(pos, SeekFlag(flags), nullptr);
     }
@@ -343,16 +1571,126 @@ bool MDK_Player_seek(mdkPlayer* p, int64_t pos, mdkSeekCallback cb)
     return MDK_Player_seekWithFlags(p, pos, MDK_SeekFlag_Default, cb);
 }
 
+void MDK_Player_setKeyframeIndex(mdkPlayer* p, bool enable, bool background)
+{
+    p->setKeyframeIndex(enable, background);
+}
+
+int MDK_Player_keyframes(mdkPlayer* p, int64_t* t, int count, bool* complete)
+{
+    auto index = p->keyframeIndex();
+    if (!index) {
+        if (complete)
+            *complete = false;
+        return 0;
+    }
+    return index->copy(t, count, complete);
+}
+
+void MDK_Player_scrub(mdkPlayer* p, int64_t pos, bool dragging, mdkSeekCallback cb)
+{
+    stopReverse(p, false);
+    if (const auto t = stopTrickPlay(p, false); t && t->defer([p, pos, dragging, cb, alive = p->alive]{
+            if (alive->load())
+                MDK_Player_scrub(p, pos, dragging, cb);
+        }))
+        return;
+    const auto flags = dragging ? SeekFlag::Default : SeekFlag(int(SeekFlag::FromStart) | int(SeekFlag::InCache));
+    if (auto c = p->frameCache())
+        c->attach();
+    p->scrubber->request(p, pos, flags, cb);
+}
+
+void MDK_Player_scrubStats(mdkPlayer* p, mdkScrubStats* stats)
+{
+    if (!stats)
+        return;
+    *stats = {};
+    p->scrubber->stats(stats);
+}
+
+void MDK_Player_setFrameCache(mdkPlayer* p, int mb)
+{
+    if (mb <= 0) {
+        p->setFrameCache(nullptr);
+        return;
+    }
+    p->setFrameCache(make_shared<FrameCache>(int64_t(mb) << 20));
+}
+
+void MDK_Player_frameCacheStats(mdkPlayer* p, mdkFrameCacheStats* stats)
+{
+    if (!stats)
+        return;
+    *stats = {};
+    if (auto c = p->frameCache())
+        c->stats(stats);
+}
+
 void MDK_Player_setPlaybackRate(mdkPlayer* p, float value)
 {
+    const auto pos = currentPosition(p);
+    const bool playing = p->reversePlayback() || p->trickPlay() || p->state() == State::Playing;
+    if (value < 0) {
+        p->trick_rate = 0;
+        stopTrickPlay(p, false);
+        p->reverse_rate = value;
+        if (auto r = p->reversePlayback())
+            r->setRate(-value);
+        else if (playing)
+            startReverse(p, pos);
+        return;
+    }
+    p->reverse_rate = 0;
+    if (p->trick_threshold > 0 && value >= p->trick_threshold) {
+        stopReverse(p, false);
+        p->trick_rate = value;
+        if (auto t = p->trickPlay())
+            t->setRate(value);
+        else if (playing)
+            startTrickPlay(p, pos);
+        return;
+    }
+    p->trick_rate = 0;
+    const bool reversing = stopReverse(p, true);
+    const bool tricking = stopTrickPlay(p, true) != nullptr;
     p->setPlaybackRate(value);
+    if (reversing || tricking)
+        p->set(State::Playing);
 }
 
 float MDK_Player_playbackRate(mdkPlayer* p)
 {
+    if (p->reverse_rate < 0)
+        return p->reverse_rate;
+    if (p->trick_rate > 0)
+        return p->trick_rate;
     return p->playbackRate();
 }
 
+void MDK_Player_setTrickPlay(mdkPlayer* p, float threshold, int interval)
+{
+    p->trick_threshold = threshold;
+    p->trick_interval = interval > 0 ? interval : 100;
+    if (p->trick_rate > 0 && (threshold <= 0 || p->trick_rate < threshold)) // leave key frame only mode
+        MDK_Player_setPlaybackRate(p, p->trick_rate);
+}
+
+void MDK_Player_setReverseBuffer(mdkPlayer* p, int mb, MDK_ReverseDropPolicy policy)
+{
+    p->reverse_budget = int64_t(mb > 0 ? mb : 256) << 20;
+    p->reverse_policy = policy;
+}
+
+void MDK_Player_reverseStats(mdkPlayer* p, mdkReverseStats* stats)
+{
+    if (!stats)
+        return;
+    *stats = {};
+    if (auto r = p->reversePlayback())
+        r->stats(stats);
+}
+
 int64_t MDK_Player_buffered(mdkPlayer* p, int64_t* bytes)
 {
     return p->buffered(bytes);
@@ -388,20 +1726,39 @@ void MDK_Player_onEvent(mdkPlayer* p, mdkMediaEventCallback cb, MDK_CallbackToke
 {
     if (!cb.opaque) {
         p->onEvent(nullptr, token);
+        if (!token) {
+            p->resetEventQueueCallback();
+            p->addMediaInfoCallbacks(false, true);
+        }
         return;
     }
     p->onEvent([cb](const MediaEvent& e){
-        mdkMediaEvent me{};
-        me.error = e.error;
-        me.category = e.category.data();
-        me.detail = e.detail.data();
-        me.decoder.stream = e.decoder.stream;
-        me.video.width = e.video.width;
-        me.video.height = e.video.height;
+        const auto me = MDK_MediaEvent_toC(e);
         return cb.cb(&me, cb.opaque);
     }, token);
 }
 
+void MDK_Player_setEventQueue(mdkPlayer* p, int capacity)
+{
+    p->setEventQueue(capacity > 0 ? make_shared<EventQueue>(capacity) : nullptr);
+}
+
+int MDK_Player_pollEvents(mdkPlayer* p, mdkMediaEvent* out, int max)
+{
+    auto q = p->eventQueue();
+    if (!q || !out || max <= 0)
+        return 0;
+    return q->poll(out, max);
+}
+
+int MDK_Player_eventQueueSize(mdkPlayer* p, int64_t* overflows)
+{
+    auto q = p->eventQueue();
+    if (overflows)
+        *overflows = q ? q->overflows() : 0;
+    return q ? q->size() : 0;
+}
+
 void MDK_Player_snapshot(mdkPlayer* p, mdkSnapshotRequest* request, mdkSnapshotCallback cb, void* vo_opaque)
 {
     assert(cb.cb && "mdkSnapshotCallback.cb can not be null");
@@ -460,6 +1817,23 @@ void MDK_Player_onLoop(mdkPlayer* p, mdkLoopCallback cb, MDK_CallbackToken* toke
 {
     if (!cb.opaque) {
         p->onLoop(nullptr, token);
+        p->removeLoopCallback(token);
+        return;
+    }
+    if (cb.cb2) {
+        auto m = p->loopMonitor();
+        if (!m)
+            m = make_shared<LoopMonitor>();
+        p->onLoop([cb, m, p](int count){
+            if (p->mediaInfo().video.empty()) {
+                cb.cb2(count, -1, cb.opaque);
+                return;
+            }
+            m->loop(count, [cb](int count, int64_t gap){
+                cb.cb2(count, gap, cb.opaque);
+            });
+        }, token);
+        p->addLoopCallback(m, token);
         return;
     }
     p->onLoop([cb](int count){
@@ -477,6 +1851,23 @@ void MDK_Player_setRange(mdkPlayer* p, int64_t a, int64_t b)
     p->setRange(a, b);
 }
 
+void MDK_Player_setLoopCache(mdkPlayer* p, bool value)
+{
+    if (p->loop_cache == value)
+        return;
+    p->loop_cache = value;
+    if (!value) {
+        p->setProperty("demux.buffer.ranges", p->loop_cache_ranges);
+        p->setProperty("demux.buffer.protocols", p->loop_cache_protocols);
+        return;
+    }
+    p->loop_cache_ranges = p->property("demux.buffer.ranges", "0");
+    p->loop_cache_protocols = p->property("demux.buffer.protocols", "http,https");
+    if (atoi(p->loop_cache_ranges.data()) < 2) // loop range, and the range of a seek out of loop range
+        p->setProperty("demux.buffer.ranges", "2");
+    addCacheProtocol(p, p->url());
+}
+
 void MDK_Player_mapPoint(mdkPlayer* p, MDK_MapDirection dir, float* x, float* y, float* z, void* vo_opaque)
 {
     p->mapPoint(Player::MapDirection(dir), x, y, z, vo_opaque);
@@ -513,6 +1904,8 @@ void MDK_Player_setActiveTracks(mdkPlayer* p, MDK_MediaType type, const int* tra
     set<int> t;
     for (int i = 0; i < count; ++i)
         t.insert(tracks[i]);
+    if (type == MDK_MediaType_Audio && !t.empty())
+        p->audio_read_track = *t.cbegin();
     p->setActiveTracks(fromC(type), t);
 }
 
@@ -568,6 +1961,30 @@ void MDK_Player_onSubtitleText(struct mdkPlayer* p, mdkSubtitleCallback cb, bool
     }, plainText);
 }
 
+void MDK_Player_framePoolStats(mdkPlayer* p, MDK_MediaType type, mdkFramePoolStats* stats)
+{
+    if (!stats)
+        return;
+    *stats = {};
+    const auto fill = [stats](const auto* pool) {
+        stats->hits = (int64_t)pool->hits();
+        stats->misses = (int64_t)pool->misses();
+        stats->capacity = pool->capacity();
+    };
+    if (type == MDK_MediaType_Video)
+        fill(p->video_pool);
+    else if (type == MDK_MediaType_Audio)
+        fill(p->audio_pool);
+}
+
+void MDK_Player_setFramePoolCapacity(mdkPlayer* p, MDK_MediaType type, int capacity)
+{
+    if (type == MDK_MediaType_Video)
+        p->video_pool->setCapacity(capacity);
+    else if (type == MDK_MediaType_Audio)
+        p->audio_pool->setCapacity(capacity);
+}
+
 const mdkPlayerAPI* mdkPlayerAPI_new()
 {
     mdkPlayerAPI* p = new mdkPlayerAPI();
@@ -645,6 +2062,33 @@ const mdkPlayerAPI* mdkPlayerAPI_new()
     SET_API(subtitleText);
     SET_API(setAudioMix);
     SET_API(onSubtitleText);
+    SET_API(framePoolStats);
+    SET_API(setFramePoolCapacity);
+    SET_API(onVideoView);
+    SET_API(onAudioView);
+    SET_API(onVideoBatch);
+    SET_API(onAudioBatch);
+    SET_API(setVideoFrameQueue);
+    SET_API(acquireVideoFrame);
+    SET_API(releaseVideoFrame);
+    SET_API(videoFrameQueueSize);
+    SET_API(setAudioReadBuffer);
+    SET_API(readAudio);
+    SET_API(audioReadBufferSize);
+    SET_API(setEventQueue);
+    SET_API(pollEvents);
+    SET_API(eventQueueSize);
+    SET_API(mediaInfoChanged);
+    SET_API(scrub);
+    SET_API(scrubStats);
+    SET_API(setKeyframeIndex);
+    SET_API(keyframes);
+    SET_API(setFrameCache);
+    SET_API(frameCacheStats);
+    SET_API(setReverseBuffer);
+    SET_API(reverseStats);
+    SET_API(setTrickPlay);
+    SET_API(setLoopCache);
 #undef SET_API
     return p;
 }
@@ -654,20 +2098,30 @@ void mdkPlayerAPI_delete(const mdkPlayerAPI** pp)
     mdkPlayerAPI_reset(pp, true);
 }
 
+void mdkPlayerAPI_deleteAsync(const struct mdkPlayerAPI** pp, mdkPlayerDeletedCallback cb)
+{
+    if (!pp || !*pp)
+        return;
+    auto api = *pp;
+    mdkPlayerAPI_reset(pp, false);
+    api->object->set(State::Stopped); // stop output now
+    PlayerReaper::instance().push(api, cb);
+}
+
+int mdkPlayerAPI_pendingDeletes()
+{
+    return PlayerReaper::instance().pending();
+}
+
 void mdkPlayerAPI_reset(const struct mdkPlayerAPI** pp, bool release)
 {
     if (!pp || !*pp)
         return;
     auto p = (*pp)->object;
 // reset callbacks to avoid accessing mdkPlayer.media_info in callbacks, media_info is destroyed before abi Player, reset callbacks in ~Player() is too late
-    p->setRenderCallback(nullptr);
-    p->onMediaStatus(nullptr);
-    p->onStateChanged(nullptr);
-    p->onEvent(nullptr);
-    p->onFrame<VideoFrame>(nullptr);
-    p->setTimeout(0, nullptr);
-    p->onLoop(nullptr);
-    p->onSync(nullptr);
+    MDK_Player_resetCallbacks(p);
+    p->scrubber->close(); // no more seeks from callbacks of finished seeks
+    p->alive->store(false); // no deferred seeks after trick play
     if (release) {
         delete p;
         delete *pp;
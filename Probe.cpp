@@ -0,0 +1,580 @@
+/*
+ * Copyright (c) 2026 WangBin <wbsecg1 at gmail.com>
+ */
+#include "mdk/c/Probe.h"
+#include "mdk/MediaInfo.h"
+#include "mdk/Player.h"
+#include "MediaInfoInternal.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#if (_WIN32 + 0)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace MDK_NS;
+namespace fs = std::filesystem;
+
+static constexpr uint32_t kMagic = 0x504b444d; // "MDKP"
+static constexpr uint32_t kKeyframesMagic = 0x4b4b444d; // "MDKK"
+static constexpr uint32_t kVersion = 1;
+static constexpr auto kProbeTimeout = chrono::seconds(30);
+
+// read only memory mapped file
+class MappedFile {
+public:
+    explicit MappedFile(const fs::path& file) {
+#if (_WIN32 + 0)
+        // FILE_SHARE_DELETE: a writer can replace the file while it's mapped
+        const auto h = CreateFileW(file.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (h == INVALID_HANDLE_VALUE)
+            return;
+        LARGE_INTEGER size{};
+        if (GetFileSizeEx(h, &size) && size.QuadPart > 0) {
+            if (const auto m = CreateFileMappingW(h, nullptr, PAGE_READONLY, 0, 0, nullptr)) {
+                data_ = (const uint8_t*)MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+                if (data_)
+                    size_ = (size_t)size.QuadPart;
+                CloseHandle(m);
+            }
+        }
+        CloseHandle(h);
+#else
+        const auto fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return;
+        struct stat st{};
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            auto d = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (d != MAP_FAILED) {
+                data_ = (const uint8_t*)d;
+                size_ = (size_t)st.st_size;
+            }
+        }
+        close(fd);
+#endif
+    }
+
+    ~MappedFile() {
+        if (!data_)
+            return;
+#if (_WIN32 + 0)
+        UnmapViewOfFile(data_);
+#else
+        munmap((void*)data_, size_);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+class Writer {
+public:
+    static constexpr bool kReading = false;
+
+    template<typename T> requires is_trivially_copyable_v<T>
+    void operator()(const T& v) {
+        const auto p = (const uint8_t*)&v;
+        data.insert(data.end(), p, p + sizeof(v));
+    }
+
+    void operator()(const string& v) {
+        (*this)((uint32_t)v.size());
+        data.insert(data.end(), v.cbegin(), v.cend());
+    }
+
+    void operator()(const map<string, string>& m) {
+        (*this)((uint32_t)m.size());
+        for (const auto& [k, v] : m) {
+            (*this)(k);
+            (*this)(v);
+        }
+    }
+
+    vector<uint8_t> data;
+};
+
+// bounds checked. ok() is false if data is truncated or corrupted
+class Reader {
+public:
+    static constexpr bool kReading = true;
+
+    Reader(const uint8_t* data, size_t size) : p_(data), end_(data + size) {}
+
+    bool ok() const { return ok_; }
+    void fail() { ok_ = false; }
+    size_t remaining() const { return size_t(end_ - p_); }
+
+    template<typename T> requires is_trivially_copyable_v<T>
+    void operator()(T& v) {
+        if (!take(sizeof(v)))
+            return;
+        memcpy(&v, p_ - sizeof(v), sizeof(v));
+    }
+
+    void operator()(string& v) {
+        uint32_t n = 0;
+        (*this)(n);
+        if (!take(n))
+            return;
+        v.assign((const char*)p_ - n, n);
+    }
+
+    void operator()(map<string, string>& m) {
+        uint32_t n = 0;
+        (*this)(n);
+        m.clear();
+        for (uint32_t i = 0; i < n && ok_; ++i) {
+            string k, v;
+            (*this)(k);
+            (*this)(v);
+            m.emplace(std::move(k), std::move(v));
+        }
+    }
+
+private:
+    bool take(size_t n) {
+        if (!ok_ || remaining() < n)
+            return ok_ = false;
+        p_ += n;
+        return true;
+    }
+
+    const uint8_t* p_;
+    const uint8_t* end_;
+    bool ok_ = true;
+};
+
+// element count, then elements. reader never allocates more elements than remaining bytes
+template<class IO, class V, class F>
+static void transfer_vector(IO& io, V& v, F&& f)
+{
+    auto n = (uint32_t)v.size();
+    io(n);
+    if constexpr (IO::kReading) {
+        if (n > io.remaining()) {
+            io.fail();
+            return;
+        }
+        v.resize(n);
+    }
+    for (auto& i : v)
+        f(i);
+}
+
+// MediaInfo, or const MediaInfo for Writer. codec extra data and images are not serialized
+template<class IO, class MI>
+static void transfer(IO& io, MI& mi)
+{
+    io(mi.start_time);
+    io(mi.duration);
+    io(mi.bit_rate);
+    io(mi.size);
+    io(mi.format);
+    io(mi.streams);
+    io(mi.metadata);
+    transfer_vector(io, mi.chapters, [&](auto& i) {
+        io(i.start_time);
+        io(i.end_time);
+        io(i.title);
+        io(i.metadata);
+    });
+    transfer_vector(io, mi.program, [&](auto& i) {
+        io(i.id);
+        transfer_vector(io, i.stream, [&](auto& s) { io(s); });
+        io(i.metadata);
+    });
+    transfer_vector(io, mi.audio, [&](auto& i) {
+        io(i.index);
+        io(i.start_time);
+        io(i.duration);
+        io(i.frames);
+        io(i.metadata);
+        auto& c = i.codec;
+        io(c.codec);
+        io(c.codec_tag);
+        io(c.bit_rate);
+        io(c.profile);
+        io(c.level);
+        io(c.frame_rate);
+        io(c.format);
+        io(c.channels);
+        io(c.channel_mask);
+        io(c.sample_rate);
+        io(c.block_align);
+        io(c.frame_size);
+    });
+    transfer_vector(io, mi.video, [&](auto& i) {
+        io(i.index);
+        io(i.start_time);
+        io(i.duration);
+        io(i.frames);
+        io(i.rotation);
+        io(i.metadata);
+        io(i.dovi.profile);
+        auto& c = i.codec;
+        io(c.codec);
+        io(c.codec_tag);
+        io(c.bit_rate);
+        io(c.profile);
+        io(c.level);
+        io(c.frame_rate);
+        io(c.format);
+        io(c.width);
+        io(c.height);
+        io(c.b_frames);
+        io(c.par);
+        io(c.color_space);
+    });
+    transfer_vector(io, mi.subtitle, [&](auto& i) {
+        io(i.index);
+        io(i.start_time);
+        io(i.duration);
+        io(i.metadata);
+        auto& c = i.codec;
+        io(c.codec);
+        io(c.codec_tag);
+        io(c.width);
+        io(c.height);
+    });
+}
+
+struct CacheKey {
+    string path; // canonical, utf8
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    uint64_t hash = 0;
+};
+
+static mutex dir_mtx;
+static fs::path cache_dir;
+static atomic<bool> cache_enabled = false;
+
+static fs::path cacheDir()
+{
+    const lock_guard<mutex> lock(dir_mtx);
+    return cache_dir;
+}
+
+// local files only
+static bool cacheKey(const char* url, CacheKey& key)
+{
+    if (!url || !*url)
+        return false;
+    string_view s(url);
+    if (s.starts_with("file://"))
+        s.remove_prefix(7);
+    else if (s.find("://") != string_view::npos)
+        return false;
+    error_code ec;
+    const auto file = fs::weakly_canonical(fs::path(u8string_view((const char8_t*)s.data(), s.size())), ec);
+    if (ec)
+        return false;
+    key.size = fs::file_size(file, ec);
+    if (ec)
+        return false;
+    key.mtime = (int64_t)fs::last_write_time(file, ec).time_since_epoch().count();
+    if (ec)
+        return false;
+    const auto u8 = file.u8string();
+    key.path.assign((const char*)u8.data(), u8.size());
+    // FNV-1a
+    uint64_t h = 0xcbf29ce484222325ULL;
+    const auto add = [&](const void* data, size_t size) {
+        for (size_t i = 0; i < size; ++i)
+            h = (h ^ ((const uint8_t*)data)[i]) * 0x100000001b3ULL;
+    };
+    add(key.path.data(), key.path.size());
+    add(&key.size, sizeof(key.size));
+    add(&key.mtime, sizeof(key.mtime));
+    key.hash = h;
+    return true;
+}
+
+// header: magic, version, lib version, key. key is verified to avoid hash collision
+template<class IO, class K>
+static void transfer_header(IO& io, K& key, uint32_t& magic, uint32_t& version, int& libVersion)
+{
+    io(magic);
+    io(version);
+    io(libVersion);
+    io(key.path);
+    io(key.size);
+    io(key.mtime);
+}
+
+static fs::path cacheFile(const fs::path& dir, const CacheKey& key, const char* ext)
+{
+    char name[48];
+    snprintf(name, sizeof(name), "%016llx.%s", (unsigned long long)key.hash, ext);
+    return dir / name;
+}
+
+// read payload of a cache entry after header is verified
+template<class F>
+static bool loadEntry(const char* url, const char* ext, uint32_t kind, F&& read)
+{
+    if (!cache_enabled.load(memory_order_relaxed))
+        return false;
+    CacheKey key;
+    if (!cacheKey(url, key))
+        return false;
+    const auto dir = cacheDir();
+    if (dir.empty())
+        return false;
+    const MappedFile f(cacheFile(dir, key, ext));
+    if (!f.data())
+        return false;
+    Reader r(f.data(), f.size());
+    CacheKey k;
+    uint32_t magic = 0, version = 0;
+    int libVersion = 0;
+    transfer_header(r, k, magic, version, libVersion);
+    if (!r.ok() || magic != kind || version != kVersion || libVersion != MDK_VERSION
+        || k.path != key.path || k.size != key.size || k.mtime != key.mtime)
+        return false;
+    read(r);
+    return r.ok();
+}
+
+template<class F>
+static void storeEntry(const char* url, const char* ext, uint32_t kind, F&& write)
+{
+    if (!cache_enabled.load(memory_order_relaxed))
+        return;
+    CacheKey key;
+    if (!cacheKey(url, key))
+        return;
+    const auto dir = cacheDir();
+    if (dir.empty())
+        return;
+    Writer w;
+    uint32_t magic = kind, version = kVersion;
+    int libVersion = MDK_VERSION;
+    transfer_header(w, key, magic, version, libVersion);
+    write(w);
+
+    const auto file = cacheFile(dir, key, ext);
+    auto tmp = file;
+#if (_WIN32 + 0)
+    const auto pid = GetCurrentProcessId();
+#else
+    const auto pid = getpid();
+#endif
+    tmp += "." + to_string(pid) + "." + to_string(hash<thread::id>()(this_thread::get_id())) + ".tmp";
+    {
+        ofstream out(tmp, ios::binary | ios::trunc);
+        if (!out.write((const char*)w.data.data(), (streamsize)w.data.size()))
+            return;
+    }
+    error_code ec;
+    fs::rename(tmp, file, ec); // atomic replace, readers see the old or new file
+    if (ec)
+        fs::remove(tmp, ec);
+}
+
+bool MDK_ProbeCache_enabled()
+{
+    return cache_enabled.load(memory_order_relaxed);
+}
+
+shared_ptr<MediaInfo> MDK_ProbeCache_load(const char* url)
+{
+    auto info = make_shared<MediaInfo>();
+    if (!loadEntry(url, "mdkprobe", kMagic, [&](Reader& r) { transfer(r, *info); }))
+        return nullptr;
+    return info;
+}
+
+void MDK_ProbeCache_store(const char* url, const MediaInfo& info)
+{
+    storeEntry(url, "mdkprobe", kMagic, [&](Writer& w) { transfer(w, info); });
+}
+
+// sorted key frame timestamps
+bool MDK_ProbeCache_loadKeyframes(const char* url, vector<int64_t>& t)
+{
+    return loadEntry(url, "mdkkeys", kKeyframesMagic, [&](Reader& r) {
+        transfer_vector(r, t, [&](int64_t& v) { r(v); });
+    });
+}
+
+void MDK_ProbeCache_storeKeyframes(const char* url, const vector<int64_t>& t)
+{
+    storeEntry(url, "mdkkeys", kKeyframesMagic, [&](Writer& w) {
+        transfer_vector(w, t, [&](const int64_t& v) { w(v); });
+    });
+}
+
+// a reused player for probing. no renderer and audio output
+static unique_ptr<Player> newProbePlayer(MDK_ProbeFlag flags)
+{
+    auto player = make_unique<Player>();
+    if (flags & MDK_ProbeFlag_HeaderOnly) {
+        player->setProperty("avformat.analyzeduration", "100000"); // us. 0 is ffmpeg default(5s)
+        player->setProperty("avformat.fpsprobesize", "0");
+        player->setProperty("avformat.probesize", "32768");
+        player->setActiveTracks(MediaType::Audio, {});
+        player->setActiveTracks(MediaType::Video, {});
+        player->setActiveTracks(MediaType::Subtitle, {});
+    }
+    return player;
+}
+
+// bytes read by io of current process, including sockets and network file systems. -1 if not supported
+static int64_t processBytesRead()
+{
+#if (_WIN32 + 0)
+    IO_COUNTERS c{};
+    if (GetProcessIoCounters(GetCurrentProcess(), &c))
+        return (int64_t)c.ReadTransferCount;
+#elif defined(__linux__)
+    if (auto f = fopen("/proc/self/io", "r")) {
+        int64_t bytes = -1;
+        if (fscanf(f, "rchar: %" SCNd64, &bytes) != 1)
+            bytes = -1;
+        fclose(f);
+        return bytes;
+    }
+#endif
+    return -1;
+}
+
+// wait for the media is unloaded, at most kProbeTimeout. A timed out player is stopped and destroyed in background, and player is reset
+static bool probe(unique_ptr<Player>& player, const char* url, MDK_ProbeFlag flags, MediaInfoInternal& out)
+{
+    struct Loading {
+        mutex mtx;
+        condition_variable cv;
+        bool done = false;
+        bool loaded = false;
+        bool abandoned = false; // timed out, out is no longer accessed
+    };
+    auto s = make_shared<Loading>(); // callback may be called after timeout
+    auto p = player.get();
+    p->setMedia(url);
+    p->prepare(0, [s, p, &out, url = string(url), flags](int64_t position, bool*) {
+        const lock_guard<mutex> lock(s->mtx);
+        if (s->abandoned)
+            return false;
+        if (position >= 0) {
+            MediaInfoToC(p->mediaInfo(), &out);
+            if (!(flags & MDK_ProbeFlag_HeaderOnly))
+                MDK_ProbeCache_store(url.data(), p->mediaInfo());
+        }
+        s->loaded = position >= 0;
+        s->done = true;
+        s->cv.notify_one();
+        return false; // unload immediately
+    });
+    {
+        unique_lock<mutex> lock(s->mtx);
+        if (!s->cv.wait_for(lock, kProbeTimeout, [&]{ return s->done; })) {
+            s->abandoned = true;
+            lock.unlock();
+            p->set(State::Stopped); // abort io
+            // destroying a player blocked by io may take a long time, do not block the rest urls
+            thread([stuck = std::move(player)]{}).detach();
+            return false;
+        }
+    }
+    p->waitFor(State::Stopped);
+    return s->loaded;
+}
+
+extern "C" {
+
+void MDK_setProbeCacheDir(const char* dir)
+{
+    fs::path d;
+    if (dir && *dir) {
+        d = fs::path(u8string_view((const char8_t*)dir, strlen(dir)));
+        error_code ec;
+        fs::create_directories(d, ec);
+    }
+    const lock_guard<mutex> lock(dir_mtx);
+    cache_dir = std::move(d);
+    cache_enabled = !cache_dir.empty();
+}
+
+int MDK_probeMany(const char** urls, int n, int concurrency, mdkProbeCallback cb)
+{
+    return MDK_probeManyWithFlags(urls, n, concurrency, MDK_ProbeFlag_Default, cb);
+}
+
+int MDK_probeManyWithFlags(const char** urls, int n, int concurrency, MDK_ProbeFlag flags, mdkProbeCallback cb)
+{
+    if (!urls || n <= 0)
+        return 0;
+    if (concurrency <= 0)
+        concurrency = (int)thread::hardware_concurrency();
+    concurrency = std::clamp(concurrency, 1, n);
+
+    atomic<int> next = 0;
+    atomic<int> loaded = 0;
+    atomic<bool> stop = false;
+    mutex cb_mtx;
+    const auto work = [&] {
+        unique_ptr<Player> player;
+        MediaInfoInternal info;
+        for (int i = next++; i < n && !stop.load(memory_order_relaxed); i = next++) {
+            const auto url = urls[i];
+            bool ok = false;
+            int64_t bytes = 0;
+            if (auto cached = MDK_ProbeCache_load(url)) {
+                MediaInfoToC(*cached, &info);
+                ok = true;
+            } else if (url && *url) {
+                if (!player)
+                    player = newProbePlayer(flags);
+                const auto bytes0 = concurrency == 1 ? processBytesRead() : -1;
+                ok = probe(player, url, flags, info);
+                bytes = bytes0 >= 0 ? std::max<int64_t>(processBytesRead() - bytes0, 0) : -1;
+            }
+            if (ok)
+                loaded++;
+            const lock_guard<mutex> lock(cb_mtx);
+            if (stop)
+                break;
+            if (!cb.opaque)
+                continue;
+            const auto mi = ok ? &info.info : nullptr;
+            if (!(cb.cb2 ? cb.cb2(i, url, mi, bytes, cb.opaque) : cb.cb(i, url, mi, cb.opaque)))
+                stop = true;
+        }
+    };
+    vector<thread> workers;
+    workers.reserve(concurrency - 1);
+    for (int i = 1; i < concurrency; ++i)
+        workers.emplace_back(work);
+    work();
+    for (auto& t : workers)
+        t.join();
+    return loaded;
+}
+
+} // extern "C"
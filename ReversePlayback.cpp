@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2026 WangBin <wbsecg1 at gmail.com>
+ */
+#include "ReversePlayback.h"
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+static int64_t frameBytes(const VideoFrame& frame)
+{
+    int64_t bytes = 0;
+    for (int i = 0; i < frame.format().planeCount(); ++i)
+        bytes += (int64_t)frame.bytesPerLine(i) * frame.height(i);
+    if (bytes <= 0) // hw frame
+        bytes = (int64_t)frame.width() * frame.height() * 3 / 2;
+    return bytes;
+}
+
+ReversePlayback::ReversePlayback(Player* target, string url, int64_t startTime, double pos, float rate, int64_t budget, MDK_ReverseDropPolicy policy)
+    : target_(target), url_(std::move(url)), start_time_(startTime), budget_(budget), policy_(policy)
+    , rate_(rate), position_(pos)
+{
+    decoder_ = thread([this]{ decode(); });
+    presenter_ = thread([this]{ present(); });
+}
+
+ReversePlayback::~ReversePlayback()
+{
+    {
+        const lock_guard<mutex> lock(mtx_);
+        stop_ = true;
+        cv_.notify_all();
+    }
+    decoder_.join();
+    presenter_.join();
+}
+
+void ReversePlayback::setRate(float value)
+{
+    const lock_guard<mutex> lock(mtx_);
+    if (anchored_) {
+        clock0_ = clock();
+        t0_ = chrono::steady_clock::now();
+    }
+    rate_ = value;
+    cv_.notify_all();
+}
+
+float ReversePlayback::rate()
+{
+    const lock_guard<mutex> lock(mtx_);
+    return rate_;
+}
+
+double ReversePlayback::position()
+{
+    const lock_guard<mutex> lock(mtx_);
+    return position_;
+}
+
+void ReversePlayback::stats(mdkReverseStats* s)
+{
+    const lock_guard<mutex> lock(mtx_);
+    s->frames = (int)frames_.size();
+    s->bytes = bytes_;
+    s->presented = presented_;
+    s->dropped = dropped_;
+    s->underruns = underruns_;
+    s->gops = gops_;
+    s->finished = finished_;
+}
+
+void ReversePlayback::decode()
+{
+    // decoded segment [key frame, end), written in hidden player video thread after a seek is finished
+    mutex seg_mtx;
+    condition_variable seg_cv;
+    vector<Frame> seg;
+    int64_t seg_bytes = 0;
+    int stride = 1;
+    int counter = 0;
+    double end = position_ - 1e-4; // exclude current frame
+    double dt = 0; // frame duration, 0 if unknown
+    bool collecting = false;
+    bool collected = false;
+    bool seeked = false;
+    int64_t result = -1;
+    atomic<double> sync = 0; // hidden player clock: a bit later than the last decoded frame, so frames are neither late nor waited
+    // declared after the states used by its callbacks, so callbacks finish before states are destroyed
+    Player player;
+    const auto wait = [&](bool& flag){
+        unique_lock<mutex> lock(seg_mtx);
+        while (!flag) {
+            seg_cv.wait_for(lock, chrono::milliseconds(10));
+            if (stopped())
+                return false;
+        }
+        flag = false;
+        return true;
+    };
+    const auto finish = [&](int64_t ret){
+        const lock_guard<mutex> lock(seg_mtx);
+        result = ret;
+        seeked = true;
+        collecting = ret >= 0;
+        seg_cv.notify_all();
+    };
+    const auto syncTo = [&](double t){ // t: frame timestamp
+        sync.store(t - double(start_time_) / 1000.0 + (dt > 0 ? dt * 2.0 : 1.0), memory_order_relaxed);
+    };
+    player.setActiveTracks(MediaType::Audio, {});
+    player.setActiveTracks(MediaType::Subtitle, {});
+    player.onSync([&]{ return sync.load(memory_order_relaxed); });
+    player.onFrame<VideoFrame>([&](VideoFrame& frame, int){
+        const auto t = frame.timestamp();
+        const lock_guard<mutex> lock(seg_mtx);
+        if (!collecting)
+            return 0;
+        if (!frame || t == TimestampEOS || t >= end) {
+            collecting = false;
+            collected = true;
+            seg_cv.notify_all();
+            return 0;
+        }
+        if (!seg.empty() && t > seg.back().t)
+            dt = t - seg.back().t;
+        syncTo(t);
+        if (counter++ % stride)
+            return 0;
+        const auto bytes = frameBytes(frame);
+        seg.push_back({frame, t, bytes});
+        seg_bytes += bytes;
+        if (seg_bytes > budget_ / 2 && seg.size() > 1) { // decimate a gop larger than the budget
+            size_t n = 0;
+            for (size_t i = 0; i < seg.size(); i += 2)
+                seg[n++] = std::move(seg[i]);
+            const auto removed = seg.size() - n;
+            seg.resize(n);
+            seg_bytes = 0;
+            for (const auto& f : seg)
+                seg_bytes += f.bytes;
+            stride *= 2;
+            const lock_guard<mutex> lock2(mtx_);
+            dropped_ += removed;
+        }
+        return 0;
+    });
+    player.setMedia(url_.data());
+    player.prepare(0, [&](int64_t position, bool*){
+        finish(position);
+        return true;
+    });
+    if (!wait(seeked) || result < 0)
+        return finishDecoding();
+    for (;;) {
+        {
+            const lock_guard<mutex> lock(seg_mtx);
+            collecting = collected = false;
+            seg.clear();
+            seg_bytes = 0;
+            stride = 1;
+            counter = 0;
+        }
+        // strictly before end, otherwise the key frame of the previous segment is found again
+        const auto target = (int64_t)llround(end * 1000.0) - start_time_ - 1;
+        if (target < 0 || !player.seek(target, SeekFlag(int(SeekFlag::FromStart) | int(SeekFlag::KeyFrame) | int(SeekFlag::Backward)), finish))
+            break;
+        if (!wait(seeked))
+            return;
+        const auto key = double(result + start_time_) / 1000.0;
+        if (result < 0 || key >= end)
+            break;
+        {
+            const lock_guard<mutex> lock(seg_mtx);
+            syncTo(key);
+        }
+        player.set(State::Playing);
+        if (!wait(collected))
+            return;
+        player.set(State::Paused);
+        vector<Frame> frames;
+        {
+            const lock_guard<mutex> lock(seg_mtx);
+            frames.swap(seg);
+        }
+        {
+            unique_lock<mutex> lock(mtx_);
+            for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+                bytes_ += it->bytes;
+                frames_.push_back(std::move(*it));
+            }
+            gops_++;
+            cv_.notify_all();
+            // decode the next gop when at most half of budget is used
+            cv_.wait(lock, [this]{ return stop_ || bytes_ <= budget_ / 2; });
+            if (stop_)
+                return;
+        }
+        end = key;
+    }
+    finishDecoding();
+}
+
+void ReversePlayback::finishDecoding()
+{
+    const lock_guard<mutex> lock(mtx_);
+    decoded_ = true;
+    cv_.notify_all();
+}
+
+bool ReversePlayback::stopped()
+{
+    const lock_guard<mutex> lock(mtx_);
+    return stop_;
+}
+
+void ReversePlayback::present()
+{
+    unique_lock<mutex> lock(mtx_);
+    bool starving = false;
+    while (!stop_) {
+        if (frames_.empty()) {
+            if (decoded_) {
+                finished_ = true;
+                cv_.wait(lock, [this]{ return stop_; });
+                return;
+            }
+            if (!starving && presented_ > 0) {
+                starving = true;
+                underruns_++;
+                if (policy_ == MDK_ReverseDropPolicy_Wait)
+                    anchored_ = false; // clock stops
+            }
+            cv_.wait(lock);
+            continue;
+        }
+        starving = false;
+        if (!anchored_) {
+            anchored_ = true;
+            clock0_ = frames_.front().t;
+            t0_ = chrono::steady_clock::now();
+        }
+        const auto c = clock();
+        if (policy_ == MDK_ReverseDropPolicy_Late) {
+            while (frames_.size() > 1 && frames_[1].t >= c) { // the next frame is due too
+                bytes_ -= frames_.front().bytes;
+                frames_.pop_front();
+                dropped_++;
+            }
+        }
+        if (frames_.front().t < c && rate_ > 0) { // not due
+            cv_.wait_for(lock, chrono::duration<double>((c - frames_.front().t) / rate_));
+            continue;
+        }
+        auto f = std::move(frames_.front());
+        frames_.pop_front();
+        bytes_ -= f.bytes;
+        position_ = f.t;
+        presented_++;
+        cv_.notify_all(); // decoder waiting for space
+        lock.unlock();
+        target_->enqueue(f.frame, nullptr);
+        lock.lock();
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2026 WangBin <wbsecg1 at gmail.com>
+ */
+#pragma once
+#include "mdk/c/Player.h"
+#include "mdk/Player.h"
+#include "mdk/VideoFrame.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace std;
+using namespace MDK_NS;
+
+/*
+  Reverse playback of a media. A hidden player(no audio and rendering) decodes GOPs in reverse order in a worker thread: seek to the key frame before current segment end,
+  decode forward to the end, then queue the frames in reverse order. Frames are presented by target player enqueue() in another thread by a clock running backward.
+  Timestamps are in seconds, the same as frame timestamps.
+ */
+class ReversePlayback {
+public:
+    ReversePlayback(Player* target, string url, int64_t startTime, double pos, float rate, int64_t budget, MDK_ReverseDropPolicy policy);
+    ~ReversePlayback();
+
+    void setRate(float value);
+    float rate();
+// timestamp of the last presented frame
+    double position();
+    void stats(mdkReverseStats* s);
+
+private:
+    struct Frame {
+        VideoFrame frame;
+        double t;
+        int64_t bytes;
+    };
+
+    double clock() const {
+        return clock0_ - chrono::duration<double>(chrono::steady_clock::now() - t0_).count() * rate_;
+    }
+
+    void decode();
+    void finishDecoding();
+    bool stopped();
+    void present();
+
+    Player* const target_;
+    const string url_;
+    const int64_t start_time_;
+    const int64_t budget_;
+    const MDK_ReverseDropPolicy policy_;
+
+    mutex mtx_;
+    condition_variable cv_;
+    deque<Frame> frames_; // in presentation order
+    int64_t bytes_ = 0;
+    float rate_;
+    double position_;
+    bool anchored_ = false;
+    double clock0_ = 0;
+    chrono::steady_clock::time_point t0_;
+    bool decoded_ = false;
+    bool finished_ = false;
+    bool stop_ = false;
+    int64_t presented_ = 0;
+    int64_t dropped_ = 0;
+    int64_t underruns_ = 0;
+    int64_t gops_ = 0;
+
+    thread decoder_;
+    thread presenter_;
+};
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2026 WangBin <wbsecg1 at gmail.com>
+ */
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+/*
+  Lock-free single producer single consumer byte ring buffer.
+  write() is called by 1 thread, read() is called by another thread.
+ */
+class RingBuffer {
+public:
+    explicit RingBuffer(size_t capacity)
+        : capacity_(capacity)
+        , data_(new uint8_t[capacity])
+    {}
+
+    size_t capacity() const { return capacity_; }
+// readable bytes
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+// producer. write at most size bytes, return written bytes
+    size_t write(const uint8_t* data, size_t size) {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        const auto head = head_.load(std::memory_order_acquire);
+        size = std::min(size, capacity_ - (tail - head));
+        const auto pos = tail % capacity_;
+        const auto n = std::min(size, capacity_ - pos);
+        memcpy(&data_[pos], data, n);
+        memcpy(&data_[0], data + n, size - n);
+        tail_.store(tail + size, std::memory_order_release);
+        return size;
+    }
+// consumer. read at most size bytes, return read bytes
+    size_t read(uint8_t* data, size_t size) {
+        const auto head = head_.load(std::memory_order_relaxed);
+        const auto tail = tail_.load(std::memory_order_acquire);
+        size = std::min(size, tail - head);
+        const auto pos = head % capacity_;
+        const auto n = std::min(size, capacity_ - pos);
+        memcpy(data, &data_[pos], n);
+        memcpy(data + n, &data_[0], size - n);
+        head_.store(head + size, std::memory_order_release);
+        return size;
+    }
+
+private:
+    const size_t capacity_;
+    std::unique_ptr<uint8_t[]> data_;
+    alignas(64) std::atomic<size_t> head_ = 0;
+    alignas(64) std::atomic<size_t> tail_ = 0;
+};
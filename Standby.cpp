@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2026 WangBin <wbsecg1 at gmail.com>
+ */
+#include "mdk/c/Standby.h"
+#include "mdk/c/MediaInfo.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+extern void MDK_Player_resetCallbacks(mdkPlayer* p);
+
+namespace {
+// a player and its state. destroyed only with the player, so callbacks can use it
+struct Slot {
+    const mdkPlayerAPI* api = nullptr;
+    mdkStandbyPool* pool = nullptr;
+    string url; // standby url
+    list<Slot*>::iterator pos; // in standby list
+    atomic<bool> cold = false;
+    atomic<int64_t> switch_time = 0; // steady clock time of promote(), 0 if time to first frame is measured
+    atomic<bool> prepared = false; // set by prepare callback
+    int64_t memory = 0; // sampled in pool thread after prepared
+};
+
+static int64_t now_ns()
+{
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+} // namespace
+
+struct mdkStandbyPool {
+    int max_standby = 0;
+    int64_t memory_budget = 0;
+    list<Slot*> standby; // the least recently preloaded first
+    unordered_map<string, Slot*> standby_url;
+    unordered_map<const mdkPlayerAPI*, Slot*> active; // promoted
+    vector<Slot*> idle;
+
+    atomic<int64_t> promoted = 0;
+    atomic<int64_t> cold = 0;
+    atomic<int64_t> promoted_ttff = 0; // sum of measured ms
+    atomic<int64_t> promoted_measured = 0;
+    atomic<int64_t> cold_ttff = 0;
+    atomic<int64_t> cold_measured = 0;
+};
+
+static bool isFirstFrame(const mdkMediaEvent* e)
+{
+    if (e->size > (int)offsetof(mdkMediaEvent, detail_id))
+        return e->category_id == MDK_EventCategory_RenderVideo && e->detail_id == MDK_EventDetail_FirstFrame;
+    return MDK_eventCategory(e->category) == MDK_EventCategory_RenderVideo && MDK_eventDetail(e->detail) == MDK_EventDetail_FirstFrame;
+}
+
+// 1st_frame event is in render thread
+static bool onPlayerEvent(const mdkMediaEvent* e, void* opaque)
+{
+    if (!isFirstFrame(e))
+        return false;
+    auto s = static_cast<Slot*>(opaque);
+    const auto t0 = s->switch_time.exchange(0, memory_order_acquire);
+    if (!t0)
+        return false;
+    const auto ms = (now_ns() - t0) / 1000000;
+    auto pool = s->pool;
+    if (s->cold.load(memory_order_relaxed)) {
+        pool->cold_ttff += ms;
+        pool->cold_measured++;
+    } else {
+        pool->promoted_ttff += ms;
+        pool->promoted_measured++;
+    }
+    return false;
+}
+
+static Slot* acquireSlot(mdkStandbyPool* pool)
+{
+    if (!pool->idle.empty()) {
+        auto s = pool->idle.back();
+        pool->idle.pop_back();
+        return s;
+    }
+    auto s = new Slot();
+    s->pool = pool;
+    s->api = mdkPlayerAPI_new();
+    s->api->onEvent(s->api->object, mdkMediaEventCallback{onPlayerEvent, s}, nullptr);
+    return s;
+}
+
+static void deleteSlot(Slot* s)
+{
+    mdkPlayerAPI_delete(&s->api); // callbacks are reset
+    delete s;
+}
+
+static void makeIdle(mdkStandbyPool* pool, Slot* s)
+{
+    s->switch_time = 0;
+    s->url.clear();
+    if ((int)pool->idle.size() >= pool->max_standby) {
+        deleteSlot(s);
+        return;
+    }
+    // callbacks set by user for the promoted media MUST NOT be called for the next media. the pool's event callback is removed too
+    MDK_Player_resetCallbacks(s->api->object);
+    s->api->onEvent(s->api->object, mdkMediaEventCallback{onPlayerEvent, s}, nullptr);
+    s->api->setState(s->api->object, MDK_State_Stopped);
+    s->api->waitFor(s->api->object, MDK_State_Stopped, -1); // required before the next prepare()
+    s->prepared = false;
+    s->memory = 0;
+    pool->idle.push_back(s);
+}
+
+static bool onPrepared(int64_t position, bool*, void* opaque)
+{
+    static_cast<Slot*>(opaque)->prepared.store(position >= 0, memory_order_release);
+    return true;
+}
+
+static void loadMedia(Slot* s, const char* url)
+{
+    s->api->setMedia(s->api->object, url);
+    s->api->prepare(s->api->object, 0, mdkPrepareCallback{onPrepared, s}, MDK_SeekFlag_Default);
+}
+
+static Slot* takeStandby(mdkStandbyPool* pool, const char* url)
+{
+    const auto it = pool->standby_url.find(url);
+    if (it == pool->standby_url.cend())
+        return nullptr;
+    auto s = it->second;
+    pool->standby_url.erase(it);
+    pool->standby.erase(s->pos);
+    return s;
+}
+
+// decoded frame size is unknown and nothing is buffered before prepared, so the last sample is used until prepared
+static int64_t estimateMemory(Slot* s)
+{
+    if (!s->prepared.load(memory_order_acquire))
+        return s->memory;
+    const auto api = s->api;
+    int64_t bytes = 0;
+    api->buffered(api->object, &bytes);
+    const auto info = api->mediaInfo(api->object);
+    for (int i = 0; info && i < info->nb_video; ++i) {
+        mdkVideoCodecParameters c{};
+        MDK_VideoStreamCodecParameters(&info->video[i], &c);
+        bytes += (int64_t)c.width * c.height * 3 / 2;
+    }
+    s->memory = bytes;
+    return bytes;
+}
+
+// evict the least recently preloaded players except the newest one
+static int64_t evict(mdkStandbyPool* pool)
+{
+    while ((int)pool->standby.size() > pool->max_standby)
+        MDK_StandbyPool_remove(pool, pool->standby.front()->url.data());
+    int64_t total = 0;
+    for (auto s : pool->standby)
+        total += estimateMemory(s);
+    while (pool->memory_budget > 0 && total > pool->memory_budget && pool->standby.size() > 1) {
+        auto s = pool->standby.front();
+        total -= s->memory;
+        MDK_StandbyPool_remove(pool, s->url.data());
+    }
+    return total;
+}
+
+extern "C" {
+
+mdkStandbyPool* MDK_StandbyPool_new(int maxStandby, int64_t memoryBudget)
+{
+    auto pool = new mdkStandbyPool();
+    pool->max_standby = std::max(maxStandby, 0);
+    pool->memory_budget = memoryBudget;
+    return pool;
+}
+
+void MDK_StandbyPool_delete(mdkStandbyPool** pp)
+{
+    if (!pp || !*pp)
+        return;
+    auto pool = *pp;
+    for (auto s : pool->standby)
+        deleteSlot(s);
+    for (auto& [api, s] : pool->active)
+        deleteSlot(s);
+    for (auto s : pool->idle)
+        deleteSlot(s);
+    delete pool;
+    *pp = nullptr;
+}
+
+const mdkPlayerAPI* MDK_StandbyPool_preload(mdkStandbyPool* pool, const char* url)
+{
+    if (!url || pool->max_standby <= 0)
+        return nullptr;
+    if (auto s = takeStandby(pool, url)) { // refresh
+        s->pos = pool->standby.insert(pool->standby.cend(), s);
+        pool->standby_url[s->url] = s;
+        return s->api;
+    }
+    auto s = acquireSlot(pool);
+    s->url = url;
+    loadMedia(s, url);
+    s->pos = pool->standby.insert(pool->standby.cend(), s);
+    pool->standby_url[s->url] = s;
+    const auto api = s->api;
+    evict(pool);
+    return api;
+}
+
+void MDK_StandbyPool_remove(mdkStandbyPool* pool, const char* url)
+{
+    if (!url)
+        return;
+    if (auto s = takeStandby(pool, url))
+        makeIdle(pool, s);
+}
+
+const mdkPlayerAPI* MDK_StandbyPool_promote(mdkStandbyPool* pool, const char* url)
+{
+    if (!url)
+        return nullptr;
+    auto s = takeStandby(pool, url);
+    const bool cold = !s;
+    if (cold) {
+        s = acquireSlot(pool);
+        loadMedia(s, url);
+        pool->cold++;
+    } else {
+        s->url.clear();
+        pool->promoted++;
+    }
+    s->cold.store(cold, memory_order_relaxed);
+    s->switch_time.store(now_ns(), memory_order_release);
+    pool->active[s->api] = s;
+    return s->api;
+}
+
+void MDK_StandbyPool_recycle(mdkStandbyPool* pool, const mdkPlayerAPI** player)
+{
+    if (!player || !*player)
+        return;
+    const auto it = pool->active.find(*player);
+    assert(it != pool->active.cend() && "player is not promoted by this pool");
+    if (it != pool->active.cend()) {
+        auto s = it->second;
+        pool->active.erase(it);
+        makeIdle(pool, s);
+    }
+    *player = nullptr;
+}
+
+void MDK_StandbyPool_stats(mdkStandbyPool* pool, mdkStandbyStats* stats)
+{
+    if (!stats)
+        return;
+    *stats = {};
+    stats->memory = evict(pool);
+    stats->standby = (int)pool->standby.size();
+    for (auto s : pool->standby) {
+        if (s->api->mediaStatus(s->api->object) & MDK_MediaStatus_Prepared)
+            stats->prepared++;
+    }
+    stats->promoted = pool->promoted;
+    stats->cold = pool->cold;
+    if (const auto n = pool->promoted_measured.load())
+        stats->promoted_ttff = pool->promoted_ttff / n;
+    if (const auto n = pool->cold_measured.load())
+        stats->cold_ttff = pool->cold_ttff / n;
+}
+
+} // extern "C"
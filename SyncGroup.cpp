@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2026 WangBin <wbsecg1 at gmail.com>
+ */
+#include "mdk/c/SyncGroup.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+namespace {
+/*
+  Seqlock protected clock. value() is lock-free and called by all members when rendering.
+  set() is serialized by group mutex.
+ */
+class MasterClock {
+public:
+    // seconds
+    double value() const {
+        for (;;) {
+            const auto s0 = seq_.load(memory_order_acquire);
+            if (s0 & 1)
+                continue;
+            const auto pos = pos_.load(memory_order_relaxed);
+            const auto t0 = t0_.load(memory_order_relaxed);
+            const auto rate = rate_.load(memory_order_relaxed);
+            const auto running = running_.load(memory_order_relaxed);
+            atomic_thread_fence(memory_order_acquire);
+            if (seq_.load(memory_order_relaxed) != s0)
+                continue;
+            if (!running)
+                return pos;
+            return pos + double(now() - t0) * 1e-9 * rate;
+        }
+    }
+
+    void set(double pos, float rate, bool running) {
+        seq_.fetch_add(1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        pos_.store(pos, memory_order_relaxed);
+        t0_.store(now(), memory_order_relaxed);
+        rate_.store(rate, memory_order_relaxed);
+        running_.store(running, memory_order_relaxed);
+        seq_.fetch_add(1, memory_order_release);
+    }
+
+    bool running() const { return running_.load(memory_order_relaxed); }
+
+private:
+    static int64_t now() {
+        return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    atomic<uint32_t> seq_ = 0;
+    atomic<double> pos_ = 0;
+    atomic<int64_t> t0_ = 0;
+    atomic<float> rate_ = 1.0f;
+    atomic<bool> running_ = false;
+};
+
+struct Member {
+    const mdkPlayerAPI* api;
+    int64_t drift = 0;
+    int64_t max_drift = 0;
+    double sum_drift = 0;
+    int64_t samples = 0;
+};
+
+// shared with seek callbacks, which may finish after group is deleted
+struct GroupState {
+    mutex mtx;
+    MasterClock clock;
+    vector<Member> members;
+    MDK_State state = MDK_State_Stopped;
+    float rate = 1.0f;
+    uint64_t seek_gen = 0;
+    bool seeking = false;
+};
+
+// released once by each member's seek callback, whatever the result, and once by MDK_SyncGroup_seek()
+struct SeekTicket {
+    shared_ptr<GroupState> d;
+    uint64_t gen;
+    atomic<int> pending;
+    atomic<int64_t> result = -1; // the 1st successful seek result in ms
+};
+
+static double clockValue(void* opaque)
+{
+    return static_cast<const MasterClock*>(opaque)->value();
+}
+
+static void releaseTicket(SeekTicket* t)
+{
+    if (t->pending.fetch_sub(1, memory_order_acq_rel) != 1)
+        return;
+    {
+        auto& d = *t->d;
+        const lock_guard<mutex> lock(d.mtx);
+        if (t->gen == d.seek_gen) { // resume from seek result
+            d.seeking = false;
+            const auto result = t->result.load(memory_order_relaxed);
+            d.clock.set(result >= 0 ? double(result) / 1000.0 : d.clock.value(), d.rate, d.state == MDK_State_Playing);
+        }
+    }
+    delete t;
+}
+
+static void onSeekFinished(int64_t ms, void* opaque)
+{
+    auto t = static_cast<SeekTicket*>(opaque);
+    int64_t none = -1;
+    if (ms >= 0)
+        t->result.compare_exchange_strong(none, ms, memory_order_relaxed);
+    releaseTicket(t);
+}
+} // namespace
+
+struct mdkSyncGroup {
+    shared_ptr<GroupState> d = make_shared<GroupState>();
+};
+
+extern "C" {
+
+mdkSyncGroup* MDK_SyncGroup_new()
+{
+    return new mdkSyncGroup();
+}
+
+void MDK_SyncGroup_delete(mdkSyncGroup** pp)
+{
+    if (!pp || !*pp)
+        return;
+    auto& d = *(*pp)->d;
+    {
+        const lock_guard<mutex> lock(d.mtx);
+        for (const auto& m : d.members)
+            m.api->onSync(m.api->object, mdkSyncCallback{}, 10);
+        d.members.clear();
+    }
+    delete *pp;
+    *pp = nullptr;
+}
+
+void MDK_SyncGroup_join(mdkSyncGroup* g, const mdkPlayerAPI* player)
+{
+    if (!player)
+        return;
+    auto& d = *g->d;
+    const lock_guard<mutex> lock(d.mtx);
+    if (any_of(d.members.cbegin(), d.members.cend(), [=](const Member& m) { return m.api == player; }))
+        return;
+    d.members.push_back({player});
+    player->setPlaybackRate(player->object, d.rate);
+    player->onSync(player->object, mdkSyncCallback{clockValue, &d.clock}, 10);
+}
+
+void MDK_SyncGroup_leave(mdkSyncGroup* g, const mdkPlayerAPI* player)
+{
+    auto& d = *g->d;
+    const lock_guard<mutex> lock(d.mtx);
+    const auto it = find_if(d.members.cbegin(), d.members.cend(), [=](const Member& m) { return m.api == player; });
+    if (it == d.members.cend())
+        return;
+    player->onSync(player->object, mdkSyncCallback{}, 10);
+    d.members.erase(it);
+}
+
+void MDK_SyncGroup_setState(mdkSyncGroup* g, MDK_State value)
+{
+    auto& d = *g->d;
+    const lock_guard<mutex> lock(d.mtx);
+    d.state = value;
+    if (value == MDK_State_Stopped) {
+        d.seeking = false;
+        d.clock.set(0, d.rate, false);
+    } else if (!d.seeking) {
+        d.clock.set(d.clock.value(), d.rate, value == MDK_State_Playing);
+    }
+    for (const auto& m : d.members)
+        m.api->setState(m.api->object, value);
+}
+
+void MDK_SyncGroup_seek(mdkSyncGroup* g, int64_t pos, MDK_SeekFlag flags)
+{
+    auto& d = *g->d;
+    SeekTicket* t = nullptr;
+    {
+        const lock_guard<mutex> lock(d.mtx);
+        d.seeking = true;
+        // the target of a relative, frame or key frame seek is unknown until finished, so the clock stops at current value
+        const bool exact = (flags & (MDK_SeekFlag_From0 | MDK_SeekFlag_FromStart)) && !(flags & (MDK_SeekFlag_FromNow | MDK_SeekFlag_Frame | MDK_SeekFlag_KeyFrame));
+        d.clock.set(exact ? double(pos) / 1000.0 : d.clock.value(), d.rate, false);
+        // 1 reference for this function, so the clock is not resumed before all members start seeking.
+        // the callback is invoked even if a seek is rejected or skipped, so the return value is ignored
+        t = new SeekTicket{g->d, ++d.seek_gen, (int)d.members.size() + 1};
+        for (const auto& m : d.members)
+            m.api->seekWithFlags(m.api->object, pos, flags, mdkSeekCallback{onSeekFinished, t});
+    }
+    releaseTicket(t);
+}
+
+void MDK_SyncGroup_setPlaybackRate(mdkSyncGroup* g, float value)
+{
+    auto& d = *g->d;
+    const lock_guard<mutex> lock(d.mtx);
+    d.rate = value;
+    d.clock.set(d.clock.value(), value, d.clock.running());
+    for (const auto& m : d.members)
+        m.api->setPlaybackRate(m.api->object, value);
+}
+
+int64_t MDK_SyncGroup_position(mdkSyncGroup* g)
+{
+    return (int64_t)llround(g->d->clock.value() * 1000.0);
+}
+
+int MDK_SyncGroup_drift(mdkSyncGroup* g, mdkSyncDrift* out, int cap)
+{
+    auto& d = *g->d;
+    const lock_guard<mutex> lock(d.mtx);
+    const bool running = d.clock.running();
+    const auto clock = (int64_t)llround(d.clock.value() * 1000.0);
+    int i = 0;
+    for (auto& m : d.members) {
+        m.drift = m.api->position(m.api->object) - clock;
+        if (running) {
+            const auto a = std::abs(m.drift);
+            m.max_drift = std::max(m.max_drift, a);
+            m.sum_drift += double(a);
+            m.samples++;
+        }
+        if (!out || i >= cap)
+            continue;
+        auto& r = out[i++];
+        r.player = m.api;
+        r.drift = m.drift;
+        r.max_drift = m.max_drift;
+        r.mean_drift = m.samples > 0 ? (int64_t)llround(m.sum_drift / double(m.samples)) : 0;
+        r.samples = m.samples;
+    }
+    return (int)d.members.size();
+}
+
+} // extern "C"
@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) 2026 WangBin <wbsecg1 at gmail.com>
+ */
+#include "mdk/c/Thumbnail.h"
+#include "mdk/MediaInfo.h"
+#include "mdk/Player.h"
+#include "mdk/VideoFrame.h"
+#include "FramePool.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace MDK_NS;
+
+extern mdkVideoFrameAPI* MDK_VideoFrame_toC(const VideoFrame& frame, FramePool<mdkVideoFrame>* pool = nullptr);
+
+namespace {
+static constexpr auto kWaitTimeout = chrono::seconds(10); // for open and each seek
+
+struct Target {
+    int index;
+    int64_t pos;
+};
+
+/*
+  A player without audio output and rendering, decodes 1 frame per seek in paused state.
+  Targets MUST be increasing, then a delivered frame older than the target(accurate) or seek result(key frame) is from a previous seek.
+ */
+class Grabber {
+public:
+    explicit Grabber(bool accurate) : accurate_(accurate) {
+        player_.setActiveTracks(MediaType::Audio, {});
+        player_.setActiveTracks(MediaType::Subtitle, {});
+        if (!accurate)
+            player_.setDecoders(MediaType::Video, {"FFmpeg:skip_frame=nokey", "FFmpeg"});
+        player_.onFrame<VideoFrame>([this](VideoFrame& frame, int){
+            if (!frame || frame.timestamp() == TimestampEOS)
+                return 0;
+            const lock_guard<mutex> lock(mtx_);
+            frame_ = frame;
+            cv_.notify_all();
+            return 0;
+        });
+    }
+
+    ~Grabber() {
+        player_.set(State::Stopped);
+        player_.waitFor(State::Stopped);
+    }
+
+// duration in ms
+    bool open(const char* url, int64_t& duration) {
+        bool ok = false;
+        player_.setMedia(url);
+        player_.prepare(0, [this](int64_t position, bool*){
+            const lock_guard<mutex> lock(mtx_);
+            result_ = position;
+            seeked_ = true;
+            cv_.notify_all();
+            return true;
+        });
+        {
+            unique_lock<mutex> lock(mtx_);
+            ok = cv_.wait_for(lock, kWaitTimeout, [this]{ return seeked_; }) && result_ >= 0;
+        }
+        if (!ok)
+            return false;
+        const auto& info = player_.mediaInfo();
+        duration = info.duration;
+        start_time_ = info.start_time;
+        if (!info.video.empty() && info.video[0].codec.frame_rate > 0)
+            frame_ms_ = 1000.0 / info.video[0].codec.frame_rate;
+        return !info.video.empty();
+    }
+
+    VideoFrame grab(int64_t pos) {
+        {
+            const lock_guard<mutex> lock(mtx_);
+            seeked_ = false;
+            frame_ = {};
+        }
+        const auto flags = accurate_ ? SeekFlag::FromStart : SeekFlag(int(SeekFlag::FromStart) | int(SeekFlag::KeyFrame) | int(SeekFlag::Backward));
+        if (!player_.seek(pos, flags, [this](int64_t ret){
+            const lock_guard<mutex> lock(mtx_);
+            result_ = ret;
+            seeked_ = true;
+            cv_.notify_all();
+        }))
+            return {};
+        unique_lock<mutex> lock(mtx_);
+        // accurate seek result can be the key frame position, so a frame of the previous target in the same gop is rejected by target.
+        // the frame at target is the nearest one <= target, allow 2 frame durations for variable frame rate
+        const auto from = accurate_ ? pos - (int64_t)llround(frame_ms_ * 2) : -1;
+        if (!cv_.wait_for(lock, kWaitTimeout, [&]{
+            return seeked_ && (result_ < 0 || (frame_ && position(frame_) >= std::max(from, result_ - 1)));
+        }))
+            return {};
+        if (result_ < 0)
+            return {};
+        return frame_;
+    }
+
+private:
+    int64_t position(const VideoFrame& frame) const {
+        return (int64_t)llround(frame.timestamp() * 1000.0) - start_time_;
+    }
+
+    const bool accurate_;
+    mutex mtx_;
+    condition_variable cv_;
+    bool seeked_ = false;
+    int64_t result_ = -1;
+    int64_t start_time_ = 0;
+    double frame_ms_ = 100; // frame duration if frame rate is unknown
+    VideoFrame frame_; // the last delivered in current grab
+    // declared after the states used by its callbacks, so callbacks finish before states are destroyed
+    Player player_;
+};
+
+using Output = function<bool(const Target& t, const VideoFrame& thumb)>;
+
+// keep aspect ratio of frame if width or height is not set
+static void thumbnailSize(const VideoFrame& frame, int& width, int& height)
+{
+    if (width <= 0 && height <= 0)
+        width = 160;
+    if (height <= 0)
+        height = std::max(2, (int)lround(double(width) * frame.height() / std::max(frame.width(), 1)) & ~1);
+    else if (width <= 0)
+        width = std::max(2, (int)lround(double(height) * frame.width() / std::max(frame.height(), 1)) & ~1);
+}
+
+// \param sorted targets sorted by position
+static int generate(const char* url, const mdkThumbnailOptions& o, const Output& out, vector<Target>& sorted, int64_t& duration)
+{
+    if (!url || !*url)
+        return 0;
+    if (o.buffers && (o.width <= 0 || o.height <= 0)) // caller can not size buffers
+        return 0;
+    auto g0 = make_unique<Grabber>(o.accurate);
+    if (!g0->open(url, duration))
+        return 0;
+    const int n = o.positions ? o.count : (duration > 0 ? o.count : 0);
+    if (n <= 0)
+        return 0;
+    sorted.resize(n);
+    for (int i = 0; i < n; ++i)
+        sorted[i] = {i, o.positions ? o.positions[i] : duration * (2 * i + 1) / (2 * n)};
+    stable_sort(sorted.begin(), sorted.end(), [](const Target& a, const Target& b) { return a.pos < b.pos; });
+
+    const int concurrency = std::clamp(o.concurrency, 1, n);
+    int width = o.width; // computed by the 1st frame
+    int height = o.height;
+    mutex size_mtx;
+    atomic<int> generated = 0;
+    atomic<bool> stop = false;
+    mutex out_mtx;
+    const auto work = [&](unique_ptr<Grabber> g, int begin, int end) {
+        if (!g) {
+            int64_t d = 0;
+            g = make_unique<Grabber>(o.accurate);
+            if (!g->open(url, d))
+                g.reset();
+        }
+        for (int i = begin; i < end && !stop.load(memory_order_relaxed); ++i) {
+            const auto& t = sorted[i];
+            const auto frame = g ? g->grab(t.pos) : VideoFrame();
+            VideoFrame thumb;
+            if (frame) {
+                int w = 0, h = 0;
+                {
+                    const lock_guard<mutex> lock(size_mtx);
+                    thumbnailSize(frame, width, height);
+                    w = width;
+                    h = height;
+                }
+                thumb = frame.to(PixelFormat::RGBA, w, h);
+            }
+            const lock_guard<mutex> lock(out_mtx);
+            if (stop)
+                break;
+            if (thumb)
+                generated++;
+            if (!out(t, thumb))
+                stop = true;
+        }
+    };
+    vector<thread> workers;
+    workers.reserve(concurrency - 1);
+    for (int i = 1; i < concurrency; ++i)
+        workers.emplace_back(work, nullptr, n * i / concurrency, n * (i + 1) / concurrency);
+    work(std::move(g0), 0, n / concurrency);
+    for (auto& t : workers)
+        t.join();
+    return generated;
+}
+
+// expand the only integer conversion("%d" or "%0Nd") to index, and "%%". user pattern is never used as printf format
+static bool expandFileName(const char* pattern, int index, string& out)
+{
+    out.clear();
+    bool expanded = false;
+    for (auto s = pattern; *s; ++s) {
+        if (*s != '%') {
+            out += *s;
+            continue;
+        }
+        if (*++s == '%') {
+            out += '%';
+            continue;
+        }
+        const bool zero = *s == '0';
+        if (zero)
+            ++s;
+        int width = 0;
+        while (*s >= '0' && *s <= '9' && width < 100)
+            width = width * 10 + (*s++ - '0');
+        if (*s != 'd' || expanded || width >= 100)
+            return false;
+        char n[128];
+        snprintf(n, sizeof(n), zero ? "%0*d" : "%*d", width, index);
+        out += n;
+        expanded = true;
+    }
+    return true;
+}
+
+// write to caller buffer and file
+static void store(const mdkThumbnailOptions& o, const Target& t, const VideoFrame& thumb)
+{
+    if (o.buffers && o.buffers[t.index]) {
+        const auto w = thumb.width();
+        const auto h = thumb.height();
+        const auto stride = o.stride > 0 ? o.stride : 4 * w;
+        const auto src = thumb.buffer(0)->constData();
+        const auto src_stride = thumb.bytesPerLine(0);
+        for (int y = 0; y < h; ++y)
+            memcpy(o.buffers[t.index] + y * stride, src + y * src_stride, std::min(stride, 4 * w));
+    }
+    string file;
+    if (o.fileName && *o.fileName && expandFileName(o.fileName, t.index, file))
+        thumb.save(file.data(), nullptr, o.quality);
+}
+
+static string vttTime(int64_t ms)
+{
+    char s[32];
+    snprintf(s, sizeof(s), "%02lld:%02d:%02d.%03d", (long long)(ms / 3600000), int(ms / 60000 % 60), int(ms / 1000 % 60), int(ms % 1000));
+    return s;
+}
+} // namespace
+
+extern "C" {
+
+int MDK_thumbnails(const char* url, const mdkThumbnailOptions* opts, mdkThumbnailCallback cb)
+{
+    if (!opts)
+        return 0;
+    const auto& o = *opts;
+    vector<Target> sorted;
+    int64_t duration = 0;
+    return generate(url, o, [&](const Target& t, const VideoFrame& thumb) {
+        if (thumb)
+            store(o, t, thumb);
+        if (!cb.opaque)
+            return true;
+        auto f = thumb ? MDK_VideoFrame_toC(thumb) : nullptr;
+        const auto ret = cb.cb(t.index, t.pos, f, cb.opaque);
+        if (f)
+            mdkVideoFrameAPI_delete(&f);
+        return ret;
+    }, sorted, duration);
+}
+
+int MDK_thumbnailSprite(const char* url, const mdkThumbnailOptions* opts, const mdkSpriteOptions* sprite)
+{
+    if (!opts || !sprite || !sprite->image || !*sprite->image)
+        return 0;
+    const auto& o = *opts;
+    vector<Target> sorted;
+    vector<VideoFrame> thumbs; // index in sorted
+    int64_t duration = 0;
+    generate(url, o, [&](const Target& t, const VideoFrame& thumb) {
+        if (thumbs.empty())
+            thumbs.resize(sorted.size());
+        if (thumb)
+            store(o, t, thumb);
+        thumbs[&t - sorted.data()] = thumb; // t is an element of sorted
+        return true;
+    }, sorted, duration);
+    const auto first = find_if(thumbs.cbegin(), thumbs.cend(), [](const VideoFrame& f) { return (bool)f; });
+    if (first == thumbs.cend())
+        return 0;
+    const int w = first->width();
+    const int h = first->height(); // all thumbnails are scaled to the size computed by the 1st decoded frame
+    assert(all_of(thumbs.cbegin(), thumbs.cend(), [=](const VideoFrame& f) { return !f || (f.width() == w && f.height() == h); }) && "thumbnail sizes are different");
+    const int cols = std::min<int>(sprite->columns > 0 ? sprite->columns : 10, (int)thumbs.size());
+    const int rows = ((int)thumbs.size() + cols - 1) / cols;
+    const int stride = w * cols * 4;
+    vector<uint8_t> sheet(size_t(stride) * h * rows);
+    int count = 0;
+    for (size_t j = 0; j < thumbs.size(); ++j) {
+        const auto& thumb = thumbs[j];
+        if (!thumb)
+            continue;
+        const auto src = thumb.buffer(0)->constData();
+        const auto src_stride = thumb.bytesPerLine(0);
+        auto dst = sheet.data() + size_t(j / cols) * h * stride + (j % cols) * w * 4;
+        for (int y = 0; y < h; ++y)
+            memcpy(dst + size_t(y) * stride, src + y * src_stride, size_t(w) * 4);
+        count++;
+    }
+    int strides[] = {stride};
+    const uint8_t* data[] = {sheet.data()};
+    const VideoFrame image(w * cols, h * rows, PixelFormat::RGBA, strides, data);
+    if (!image.save(sprite->image, nullptr, o.quality))
+        return 0;
+    if (!sprite->vtt || !*sprite->vtt)
+        return count;
+    ofstream vtt(sprite->vtt, ios::binary | ios::trunc);
+    if (!vtt)
+        return count;
+    const auto imageUrl = sprite->imageUrl && *sprite->imageUrl ? sprite->imageUrl : sprite->image;
+    vtt << "WEBVTT\n\n";
+    for (size_t j = 0; j < thumbs.size(); ++j) {
+        if (!thumbs[j])
+            continue;
+        const auto start = sorted[j].pos;
+        auto end = j + 1 < sorted.size() ? sorted[j + 1].pos : duration;
+        if (end <= start)
+            end = start + 1000;
+        vtt << vttTime(start) << " --> " << vttTime(end) << "\n"
+            << imageUrl << "#xywh=" << (j % cols) * w << ',' << (j / cols) * h << ',' << w << ',' << h << "\n\n";
+    }
+    return count;
+}
+
+} // extern "C"
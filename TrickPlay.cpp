@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2026 WangBin <wbsecg1 at gmail.com>
+ */
+#include "TrickPlay.h"
+#include <cmath>
+
+TrickPlay::TrickPlay(Player* target, int64_t pos, int64_t duration, float rate, int interval)
+    : target_(target), duration_(duration), interval_(interval), rate_(rate), clock0_(pos), position_(pos)
+{
+    thread_ = thread([this]{ run(); });
+}
+
+TrickPlay::~TrickPlay()
+{
+    stop();
+}
+
+void TrickPlay::stop()
+{
+    {
+        const lock_guard<mutex> lock(mtx_);
+        stop_ = true;
+        cv_.notify_all();
+    }
+    if (thread_.joinable())
+        thread_.join();
+}
+
+bool TrickPlay::defer(function<void()> f)
+{
+    const lock_guard<mutex> lock(seek_->mtx);
+    if (seek_->done)
+        return false;
+    if (seek_->then)
+        seek_->then = [a = std::move(seek_->then), b = std::move(f)]{ a(); b(); };
+    else
+        seek_->then = std::move(f);
+    return true;
+}
+
+void TrickPlay::setRate(float value)
+{
+    const lock_guard<mutex> lock(mtx_);
+    clock0_ = clock();
+    t0_ = chrono::steady_clock::now();
+    rate_ = value;
+}
+
+int64_t TrickPlay::clock() const
+{
+    const auto t = clock0_ + (int64_t)llround(chrono::duration<double, milli>(chrono::steady_clock::now() - t0_).count() * rate_);
+    return duration_ > 0 ? std::min(t, duration_) : t;
+}
+
+int64_t TrickPlay::syncPosition()
+{
+    const lock_guard<mutex> lock(mtx_);
+    return clock();
+}
+
+int64_t TrickPlay::position()
+{
+    const lock_guard<mutex> lock(mtx_);
+    return position_;
+}
+
+void TrickPlay::run()
+{
+    const auto s = seek_;
+    unique_lock<mutex> lock(mtx_);
+    while (!stop_) {
+        const auto target = std::max(clock(), position_ + 1); // next key frame
+        if (duration_ > 0 && target >= duration_) {
+            cv_.wait(lock, [this]{ return stop_; });
+            return;
+        }
+        const auto t0 = chrono::steady_clock::now();
+        lock.unlock();
+        {
+            const lock_guard<mutex> lock2(s->mtx);
+            s->done = false;
+        }
+        bool ok = target_->seek(target, SeekFlag(int(SeekFlag::FromStart) | int(SeekFlag::KeyFrame)), [s](int64_t ret){
+            function<void()> then;
+            {
+                const lock_guard<mutex> lock(s->mtx);
+                s->result = ret;
+                s->done = true;
+                then = std::move(s->then);
+                s->then = nullptr;
+                s->cv.notify_all();
+            }
+            if (then) // deferred seek after stop()
+                then();
+        });
+        int64_t result = -1;
+        if (!ok) {
+            const lock_guard<mutex> lock2(s->mtx);
+            s->done = true;
+        } else {
+            unique_lock<mutex> lock2(s->mtx);
+            while (!s->done && !stopped())
+                s->cv.wait_for(lock2, chrono::milliseconds(10));
+            ok = s->done && s->result >= 0;
+            result = s->result;
+        }
+        lock.lock();
+        if (ok && result > position_)
+            position_ = result;
+        else if (ok) // no key frame after target
+            duration_ = position_;
+        cv_.wait_until(lock, t0 + chrono::milliseconds(interval_), [this]{ return stop_; });
+    }
+}
+
+bool TrickPlay::stopped()
+{
+    const lock_guard<mutex> lock(mtx_);
+    return stop_;
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2026 WangBin <wbsecg1 at gmail.com>
+ */
+#pragma once
+#include "mdk/Player.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+using namespace MDK_NS;
+
+/*
+  Key frame only fast forward. Target player is paused, and a virtual clock runs at playback rate. At most 1 forward key frame seek to the clock is running,
+  so only key frames are decoded and presented, and at most 1 seek per interval.
+  Positions are in milliseconds, the same as Player.position().
+ */
+class TrickPlay {
+public:
+    TrickPlay(Player* target, int64_t pos, int64_t duration, float rate, int interval);
+    ~TrickPlay();
+
+// stop seeking key frames. the running key frame seek is not waited
+    void stop();
+// the core skips a seek while the previous one is unfinished, so a seek after stop() should be deferred by this.
+// f is called in seek callback thread if the key frame seek is still running, and true is returned. otherwise false is returned and f is not called
+    bool defer(function<void()> f);
+
+    void setRate(float value);
+// virtual clock
+    int64_t clock() const;
+    int64_t syncPosition();
+// position of the presented key frame
+    int64_t position();
+
+private:
+    // shared with seek callbacks, which may finish after this object is destroyed
+    struct Seek {
+        mutex mtx;
+        condition_variable cv;
+        int64_t result = -1;
+        bool done = true; // no seek in flight
+        function<void()> then; // called when done
+    };
+
+    void run();
+    bool stopped();
+
+    Player* const target_;
+    int64_t duration_;
+    const int interval_;
+
+    mutex mtx_;
+    condition_variable cv_;
+    float rate_;
+    int64_t clock0_;
+    chrono::steady_clock::time_point t0_ = chrono::steady_clock::now();
+    int64_t position_;
+    bool stop_ = false;
+    const shared_ptr<Seek> seek_ = make_shared<Seek>();
+    thread thread_;
+};
@@ -1,8 +1,9 @@
 /*
- * Copyright (c) 2020-2025 WangBin <wbsecg1 at gmail.com>
+ * Copyright (c) 2020-2026 WangBin <wbsecg1 at gmail.com>
  */
 #include "mdk/c/VideoFrame.h"
 #include "mdk/VideoFrame.h"
+#include "FramePool.h"
 #include <atomic>
 #include <cassert>
 #include <cstdlib>
@@ -13,6 +14,8 @@ using namespace MDK_NS;
 struct mdkVideoFrame {
     VideoFrame frame;
     atomic<int> ref = 1;
+    FramePool<mdkVideoFrame>* pool = nullptr; // null if not from a pool
+    mdkVideoFrameAPI api{}; // api.object == this. api and object are allocated together
 };
 
 static PixelFormat fromC(MDK_PixelFormat fmt)
@@ -85,11 +88,19 @@ static MDK_PixelFormat toC(PixelFormat fmt)
 #undef CASE_FMT
 }
 
-mdkVideoFrameAPI* MDK_VideoFrame_toC(const VideoFrame& frame);
+mdkVideoFrameAPI* MDK_VideoFrame_toC(const VideoFrame& frame, FramePool<mdkVideoFrame>* pool = nullptr);
 
 extern "C" {
 static void init_mdkVideoFrameAPI(mdkVideoFrameAPI* p);
 
+static mdkVideoFrame* new_mdkVideoFrame()
+{
+    auto f = new mdkVideoFrame();
+    f->api.object = f;
+    init_mdkVideoFrameAPI(&f->api);
+    return f;
+}
+
 int MDK_VideoFrame_planeCount(mdkVideoFrame* p)
 {
     return p->frame.format().planeCount();
@@ -277,6 +288,7 @@ bool MDK_VideoFrame_fromCUDA(mdkVideoFrame* p, mdkVideoBufferPool** pool, const
 
 void init_mdkVideoFrameAPI(mdkVideoFrameAPI* p)
 {
+    p->size = sizeof(mdkVideoFrameAPI);
 #define SET_API(FN) p->FN = MDK_VideoFrame_##FN
     SET_API(planeCount);
     SET_API(width);
@@ -306,11 +318,9 @@ void init_mdkVideoFrameAPI(mdkVideoFrameAPI* p)
 
 mdkVideoFrameAPI* mdkVideoFrameAPI_new(int width/*=0*/, int height/*=0*/, MDK_PixelFormat format/*=Unknown*/)
 {
-    mdkVideoFrameAPI* p = new mdkVideoFrameAPI();
-    p->object = new mdkVideoFrame();
-    p->object->frame = VideoFrame(width, height, fromC(format));
-    init_mdkVideoFrameAPI(p);
-    return p;
+    auto f = new_mdkVideoFrame();
+    f->frame = VideoFrame(width, height, fromC(format));
+    return &f->api;
 }
 
 void mdkVideoFrameAPI_delete(mdkVideoFrameAPI** pp)
@@ -320,8 +330,13 @@ void mdkVideoFrameAPI_delete(mdkVideoFrameAPI** pp)
 
 mdkVideoFrameAPI* mdkVideoFrameAPI_ref(mdkVideoFrameAPI* p)
 {
-    if (p)
-        p->object->ref++;
+    if (!p)
+        return p;
+    if (p->object->ref == 0) { // borrowed view
+        assert(false && "video frame view escapes the callback. use to() or mdkVideoFrameAPI_new() to create a new frame instead");
+        return MDK_VideoFrame_toC(p->object->frame);
+    }
+    p->object->ref++;
     return p;
 }
 
@@ -329,12 +344,21 @@ void mdkVideoFrameAPI_unref(mdkVideoFrameAPI** pp)
 {
     if (!pp || !*pp)
         return;
-    auto p = *pp;
-    if (--p->object->ref == 0) {
-        delete p->object;
-        delete p;
-    }
+    auto f = (*pp)->object;
     *pp = nullptr;
+    assert(f->ref > 0 && "video frame view is not owned by user");
+    if (--f->ref != 0)
+        return;
+    auto pool = f->pool;
+    if (!pool) {
+        delete f;
+        return;
+    }
+    f->frame = VideoFrame(); // release frame data now instead of when the node is reused
+    f->ref = 1;
+    if (!pool->recycle(f))
+        delete f;
+    pool->release();
 }
 
 void mdkVideoBufferPoolFree(mdkVideoBufferPool** pool)
@@ -348,15 +372,40 @@ void mdkVideoBufferPoolFree(mdkVideoBufferPool** pool)
 
 } // extern "C"
 
-mdkVideoFrameAPI* MDK_VideoFrame_toC(const VideoFrame& frame)
+mdkVideoFrameAPI* MDK_VideoFrame_toC(const VideoFrame& frame, FramePool<mdkVideoFrame>* pool)
 {
     if (!frame && frame.timestamp() != TimestampEOS) // TODO: special frames, e.g. EOS
         return nullptr;
-    mdkVideoFrameAPI* api = new mdkVideoFrameAPI();
-    api->object = new mdkVideoFrame();
-    api->object->frame = frame;
-    init_mdkVideoFrameAPI(api);
-    return api;
+    mdkVideoFrame* f = nullptr;
+    if (pool) {
+        f = pool->acquire();
+        f->pool = pool;
+    } else {
+        f = new_mdkVideoFrame();
+    }
+    f->frame = frame;
+    return &f->api;
+}
+
+void MDK_VideoFrame_view(VideoFrame& frame, int track, void (*cb)(const mdkVideoFrameAPI*, int, void*), void* opaque)
+{
+    if (!frame && frame.timestamp() != TimestampEOS) {
+        cb(nullptr, track, opaque);
+        return;
+    }
+    mdkVideoFrame f; // no heap allocation
+    f.ref.store(0, memory_order_relaxed); // not owned by anyone, ref() and unref() are invalid
+    f.frame = std::move(frame);
+    f.api.object = &f;
+    init_mdkVideoFrameAPI(&f.api);
+    cb(&f.api, track, opaque);
+    assert(f.ref == 0 && "video frame view escapes the callback");
+    frame = std::move(f.frame);
+}
+
+FramePool<mdkVideoFrame>* MDK_VideoFrame_newPool(int capacity)
+{
+    return new FramePool<mdkVideoFrame>(capacity, new_mdkVideoFrame, [](mdkVideoFrame* f) { delete f; });
 }
 
 VideoFrame MDK_VideoFrame_fromC(mdkVideoFrameAPI* p)
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2026 WangBin <wbsecg1 at gmail.com>
+ */
+// Create and destroy frame handles, and report time per handle of:
+// - assign: init_mdkVideoFrameAPI() assigns every function member, the current implementation
+// - copy table: copy a prebuilt static function table into the handle, the previous shared table implementation
+// - video api, audio api: mdkVideoFrameAPI_new() + mdkVideoFrameAPI_delete() and the audio ones, including the frame in handle
+// usage: mdk-frame-bench [-n handles]
+#include "../VideoFrame.cpp" // new_mdkVideoFrame(), init_mdkVideoFrameAPI()
+#include "mdk/c/AudioFrame.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+static void* volatile sink; // new and delete of a handle are not optimized out
+
+template<class F>
+static void run(const char* name, int n, F&& f)
+{
+    const auto t0 = chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i)
+        f();
+    const auto ns = chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count();
+    printf("%s: %.1fns/handle\n", name, ns / n);
+}
+
+int main(int argc, char** argv)
+{
+    int n = 1000000;
+    if (argc > 2 && !strcmp(argv[1], "-n"))
+        n = std::max(atoi(argv[2]), 1);
+    printf("handle: %d bytes, function table: %d bytes, %d handles\n", (int)sizeof(mdkVideoFrame), (int)sizeof(mdkVideoFrameAPI), n);
+    run("assign", n, []{
+        auto f = new_mdkVideoFrame();
+        sink = f;
+        delete f;
+    });
+    static const auto table = []{
+        mdkVideoFrameAPI t{};
+        init_mdkVideoFrameAPI(&t);
+        return t;
+    }();
+    run("copy table", n, []{
+        auto f = new mdkVideoFrame();
+        f->api = table;
+        f->api.object = f;
+        sink = f;
+        delete f;
+    });
+    run("video api", n, []{
+        auto f = mdkVideoFrameAPI_new(0, 0, MDK_PixelFormat_Unknown);
+        mdkVideoFrameAPI_delete(&f);
+    });
+    run("audio api", n, []{
+        auto f = mdkAudioFrameAPI_new(MDK_SampleFormat_Unknown, 0, 0, 0);
+        mdkAudioFrameAPI_delete(&f);
+    });
+    return 0;
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2026 WangBin <wbsecg1 at gmail.com>
+ */
+// Convert a synthetic MediaInfo with thousands of chapters and streams(DVD/Blu-ray style) to C structures, and report time per conversion of:
+// - vectors: the previous layout, 5 vectors filled by push_back without reserve
+// - arena: MediaInfoToC() to a new MediaInfoInternal, i.e. 1 allocation
+// - arena reused: MediaInfoToC() to the same MediaInfoInternal, no allocation after the 1st conversion
+// usage: mdk-mediainfo-bench [-chapters n] [-streams n] [-n iterations]
+#include "../MediaInfo.cpp" // static from_abi()
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+struct MediaInfoVectors {
+    MediaInfo abi;
+    mdkMediaInfo info{};
+    vector<mdkChapterInfo> c;
+    vector<mdkAudioStreamInfo> a;
+    vector<mdkVideoStreamInfo> v;
+    vector<mdkSubtitleStreamInfo> s;
+    vector<mdkProgramInfo> p;
+};
+
+template<class T, class InfoAbi>
+static T* fill(vector<T>& out, const vector<InfoAbi>& in)
+{
+    for (const auto& i : in) {
+        T ci{};
+        from_abi(i, ci);
+        out.push_back(ci);
+    }
+    return out.empty() ? nullptr : &out[0];
+}
+
+static void MediaInfoToCVectors(const MediaInfo& abi, MediaInfoVectors* out)
+{
+    *out = MediaInfoVectors{};
+    out->abi = abi;
+    out->info.chapters = fill(out->c, out->abi.chapters);
+    out->info.programs = fill(out->p, out->abi.program);
+    out->info.audio = fill(out->a, out->abi.audio);
+    out->info.video = fill(out->v, out->abi.video);
+    out->info.subtitle = fill(out->s, out->abi.subtitle);
+    from_abi(out->abi, out->info);
+}
+
+static MediaInfo synthetic(int chapters, int streams)
+{
+    MediaInfo info;
+    info.format = "mpegts";
+    info.duration = 3 * 3600 * 1000;
+    for (int i = 0; i < chapters; ++i)
+        info.chapters.push_back({i * 1000LL, (i + 1) * 1000LL, "Chapter " + to_string(i + 1), {}});
+    for (int i = 0; i < streams; ++i) {
+        AudioStreamInfo a;
+        a.index = i * 3;
+        a.codec.codec = "ac3";
+        a.codec.channels = 6;
+        a.codec.sample_rate = 48000;
+        a.metadata["language"] = "eng";
+        info.audio.push_back(a);
+        VideoStreamInfo v;
+        v.index = i * 3 + 1;
+        v.codec.codec = "mpeg2video";
+        v.codec.width = 720;
+        v.codec.height = 480;
+        info.video.push_back(v);
+        SubtitleStreamInfo s;
+        s.index = i * 3 + 2;
+        s.codec.codec = "dvd_subtitle";
+        s.metadata["language"] = "eng";
+        info.subtitle.push_back(s);
+        info.program.push_back({i, {a.index, v.index, s.index}, {}});
+    }
+    return info;
+}
+
+template<class F>
+static void run(const char* name, int n, F&& convert)
+{
+    const auto t0 = chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i)
+        convert();
+    const auto us = chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count();
+    printf("%s: %.2fus/conversion\n", name, us / n);
+}
+
+int main(int argc, char** argv)
+{
+    int chapters = 4000;
+    int streams = 1000;
+    int n = 200;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "-chapters"))
+            chapters = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "-streams"))
+            streams = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "-n"))
+            n = std::max(atoi(argv[i + 1]), 1);
+    }
+    const auto info = synthetic(chapters, streams);
+    printf("%d chapters, %d audio/video/subtitle streams and programs, %d iterations\n", chapters, streams, n);
+    // MediaInfo copy is included in all cases
+    run("vectors", n, [&]{
+        MediaInfoVectors out;
+        MediaInfoToCVectors(info, &out);
+    });
+    run("arena", n, [&]{
+        MediaInfoInternal out;
+        MediaInfoToC(info, &out);
+    });
+    MediaInfoInternal reused;
+    run("arena reused", n, [&]{ MediaInfoToC(info, &reused); });
+    return 0;
+}
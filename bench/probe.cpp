@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2026 WangBin <wbsecg1 at gmail.com>
+ */
+// Probe all regular files in a directory by MDK_probeManyWithFlags(), and report files per second, and bytes read if concurrency is 1.
+// usage: mdk-probe-bench dir [-c concurrency] [-header | -cache cache_dir]
+// with -cache, the directory is probed twice, the 2nd run reads media info from probe cache. -header can not be used with -cache because header only results are not cached
+#include "mdk/c/Probe.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static void run(const char* name, const vector<const char*>& urls, int concurrency, MDK_ProbeFlag flags)
+{
+    int64_t bytes = 0; // -1 if unknown
+    mdkProbeCallback cb{};
+    cb.cb2 = [](int, const char*, const mdkMediaInfo*, int64_t n, void* opaque) {
+        auto& total = *static_cast<int64_t*>(opaque);
+        total = total < 0 || n < 0 ? -1 : total + n;
+        return true;
+    };
+    cb.opaque = &bytes;
+    const auto t0 = chrono::steady_clock::now();
+    const int loaded = MDK_probeManyWithFlags(const_cast<const char**>(urls.data()), (int)urls.size(), concurrency, flags, cb);
+    const auto s = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    printf("%s: %d/%d files loaded in %.3fs, %.1f files/s", name, loaded, (int)urls.size(), s, s > 0 ? urls.size() / s : 0.0);
+    if (bytes >= 0)
+        printf(", %lld bytes read, %.1f KB/file", (long long)bytes, bytes / 1024.0 / urls.size());
+    printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+    const char* dir = nullptr;
+    const char* cache = nullptr;
+    int concurrency = 0;
+    auto flags = MDK_ProbeFlag_Default;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-c") && i + 1 < argc)
+            concurrency = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-header"))
+            flags = MDK_ProbeFlag_HeaderOnly;
+        else if (!strcmp(argv[i], "-cache") && i + 1 < argc)
+            cache = argv[++i];
+        else
+            dir = argv[i];
+    }
+    if (cache && (flags & MDK_ProbeFlag_HeaderOnly))
+        printf("-header can not be used with -cache, header only results are not cached\n");
+    if (!dir || (cache && (flags & MDK_ProbeFlag_HeaderOnly))) {
+        printf("usage: %s dir [-c concurrency] [-header | -cache cache_dir]\n", argv[0]);
+        return 1;
+    }
+    vector<string> files;
+    error_code ec;
+    for (const auto& e : fs::directory_iterator(dir, ec)) {
+        if (e.is_regular_file())
+            files.push_back(e.path().string());
+    }
+    if (files.empty()) {
+        printf("no file in %s\n", dir);
+        return 1;
+    }
+    vector<const char*> urls;
+    urls.reserve(files.size());
+    for (const auto& f : files)
+        urls.push_back(f.data());
+    MDK_setProbeCacheDir(cache);
+    run(cache ? "cold" : "probe", urls, concurrency, flags);
+    if (cache)
+        run("cached", urls, concurrency, flags);
+    return 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2026 WangBin <wbsecg1 at gmail.com>
+ */
+// Seek a media to evenly distributed positions and report seek latency(from seekWithFlags() to callback) without and with a complete key frame index.
+// - keyframe: KeyFrame|Backward|FromStart seeks, served as forward seeks to the indexed key frame if the index is complete
+// - accurate: FromStart seeks. the index is not used, listed as a reference
+// usage: mdk-seek-bench url [-n seeks]
+#include "mdk/c/MediaInfo.h"
+#include "mdk/c/Player.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+struct Waiter {
+    mutex mtx;
+    condition_variable cv;
+    bool done = false;
+    int64_t result = -1;
+
+    void finish(int64_t value) {
+        const lock_guard<mutex> lock(mtx);
+        result = value;
+        done = true;
+        cv.notify_all();
+    }
+
+    int64_t wait() {
+        unique_lock<mutex> lock(mtx);
+        if (!cv.wait_for(lock, chrono::seconds(30), [this]{ return done; }))
+            return -1;
+        done = false;
+        return result;
+    }
+};
+
+static void run(const char* name, const mdkPlayerAPI* p, int64_t duration, int n, MDK_SeekFlag flags)
+{
+    Waiter w;
+    vector<double> ms;
+    for (int i = 0; i < n; ++i) {
+        const auto pos = duration * (2 * i + 1) / (2 * n); // not key frames mostly
+        const auto t0 = chrono::steady_clock::now();
+        if (!p->seekWithFlags(p->object, pos, flags, mdkSeekCallback{[](int64_t ms, void* opaque){
+                static_cast<Waiter*>(opaque)->finish(ms);
+            }, &w}))
+            continue;
+        if (w.wait() < 0)
+            continue;
+        ms.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count());
+    }
+    if (ms.empty()) {
+        printf("%s: no seek finished\n", name);
+        return;
+    }
+    sort(ms.begin(), ms.end());
+    double total = 0;
+    for (auto v : ms)
+        total += v;
+    printf("%s: %d/%d seeks, mean %.1fms, median %.1fms, max %.1fms\n", name, (int)ms.size(), n, total / ms.size(), ms[ms.size() / 2], ms.back());
+}
+
+int main(int argc, char** argv)
+{
+    const char* url = nullptr;
+    int n = 50;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            n = std::max(atoi(argv[++i]), 1);
+        else
+            url = argv[i];
+    }
+    if (!url) {
+        printf("usage: %s url [-n seeks]\n", argv[0]);
+        return 1;
+    }
+    auto p = mdkPlayerAPI_new();
+    int64_t duration = 0;
+    {
+        Waiter w;
+        p->setMedia(p->object, url);
+        p->prepare(p->object, 0, mdkPrepareCallback{[](int64_t position, bool*, void* opaque){
+            static_cast<Waiter*>(opaque)->finish(position);
+            return true;
+        }, &w}, MDK_SeekFlag_Default);
+        if (w.wait() >= 0)
+            duration = p->mediaInfo(p->object)->duration;
+    }
+    if (duration <= 0) {
+        printf("failed to load %s or unknown duration\n", url);
+        mdkPlayerAPI_delete(&p);
+        return 1;
+    }
+    const auto keyframe = MDK_SeekFlag(MDK_SeekFlag_KeyFrame | MDK_SeekFlag_Backward | MDK_SeekFlag_FromStart);
+    run("keyframe", p, duration, n, keyframe);
+    run("accurate", p, duration, n, MDK_SeekFlag_FromStart);
+
+    p->setKeyframeIndex(p->object, true, true);
+    bool complete = false;
+    for (int i = 0; i < 6000 && !complete; ++i) { // 10min
+        this_thread::sleep_for(chrono::milliseconds(100));
+        p->keyframes(p->object, nullptr, 0, &complete);
+    }
+    if (!complete) {
+        printf("key frame index is not completed\n");
+        mdkPlayerAPI_delete(&p);
+        return 1;
+    }
+    printf("%d key frames indexed\n", p->keyframes(p->object, nullptr, 0, nullptr));
+    run("keyframe indexed", p, duration, n, keyframe);
+    run("accurate indexed", p, duration, n, MDK_SeekFlag_FromStart);
+    mdkPlayerAPI_delete(&p);
+    return 0;
+}
@@ -4,6 +4,7 @@
 #include "mdk/c/global.h"
 #include "mdk/global.h"
 #include <string.h>
+#include <string_view>
 #if (_WIN32 + 0)
 #include <intrin.h>
 #endif
@@ -96,6 +97,48 @@ bool MDK_getGlobalOptionPtr(const char* key, void** value)
     return false;
 }
 
+MDK_EventCategory MDK_eventCategory(const char* category)
+{
+    static constexpr struct {
+        string_view name;
+        MDK_EventCategory id;
+    } kCategories[] = {
+        {"render.video", MDK_EventCategory_RenderVideo},
+        {"decoder.audio", MDK_EventCategory_DecoderAudio},
+        {"decoder.video", MDK_EventCategory_DecoderVideo},
+        {"decoder.subtitle", MDK_EventCategory_DecoderSubtitle},
+        {"video", MDK_EventCategory_Video},
+        {"reader.buffering", MDK_EventCategory_ReaderBuffering},
+        {"thread.audio", MDK_EventCategory_ThreadAudio},
+        {"thread.video", MDK_EventCategory_ThreadVideo},
+        {"thread.subtitle", MDK_EventCategory_ThreadSubtitle},
+        {"snapshot", MDK_EventCategory_Snapshot},
+        {"cc", MDK_EventCategory_CC},
+    };
+    if (!category)
+        return MDK_EventCategory_Unknown;
+    const string_view s(category);
+    for (const auto& c : kCategories) {
+        if (c.name == s)
+            return c.id;
+    }
+    return MDK_EventCategory_Unknown;
+}
+
+MDK_EventDetail MDK_eventDetail(const char* detail)
+{
+    if (!detail)
+        return MDK_EventDetail_Unknown;
+    const string_view s(detail);
+    if (s == "1st_frame")
+        return MDK_EventDetail_FirstFrame;
+    if (s == "open")
+        return MDK_EventDetail_Open;
+    if (s == "size")
+        return MDK_EventDetail_Size;
+    return MDK_EventDetail_Unknown;
+}
+
 char* MDK_strdup(const char* strSource)
 {
 #if defined(_MSC_VER)
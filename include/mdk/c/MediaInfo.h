@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2025 WangBin <wbsecg1 at gmail.com>
+ * Copyright (c) 2019-2026 WangBin <wbsecg1 at gmail.com>
  * This file is part of MDK
  * MDK SDK: https://github.com/wang-bin/mdk-sdk
  * Free for opensource softwares or non-commercial use.
@@ -49,6 +49,7 @@ typedef struct mdkAudioStreamInfo {
 MDK_API void MDK_AudioStreamCodecParameters(const mdkAudioStreamInfo*, mdkAudioCodecParameters* p);
 /* see document of mdkStringMapEntry */
 MDK_API bool MDK_AudioStreamMetadata(const mdkAudioStreamInfo*, mdkStringMapEntry* entry);
+MDK_API int MDK_AudioStreamMetadataAll(const mdkAudioStreamInfo*, mdkStringMapEntry* out, int cap);
 
 typedef struct mdkVideoCodecParameters {
     const char* codec;
@@ -86,6 +87,7 @@ typedef struct mdkVideoStreamInfo {
 MDK_API void MDK_VideoStreamCodecParameters(const mdkVideoStreamInfo*, mdkVideoCodecParameters* p);
 /* see document of mdkStringMapEntry */
 MDK_API bool MDK_VideoStreamMetadata(const mdkVideoStreamInfo*, mdkStringMapEntry* entry);
+MDK_API int MDK_VideoStreamMetadataAll(const mdkVideoStreamInfo*, mdkStringMapEntry* out, int cap);
 MDK_API const uint8_t* MDK_VideoStreamData(const mdkVideoStreamInfo*, int* len, int flags);
 
 typedef struct mdkSubtitleCodecParameters {
@@ -108,6 +110,7 @@ typedef struct mdkSubtitleStreamInfo {
 
 MDK_API void MDK_SubtitleStreamCodecParameters(const mdkSubtitleStreamInfo*, mdkSubtitleCodecParameters* p);
 MDK_API bool MDK_SubtitleStreamMetadata(const mdkSubtitleStreamInfo*, mdkStringMapEntry* entry);
+MDK_API int MDK_SubtitleStreamMetadataAll(const mdkSubtitleStreamInfo*, mdkStringMapEntry* out, int cap);
 
 typedef struct mdkChapterInfo {
     int64_t start_time;
@@ -126,6 +129,7 @@ typedef struct mdkProgramInfo {
 } mdkProgramInfo;
 
 MDK_API bool MDK_ProgramMetadata(const mdkProgramInfo*, mdkStringMapEntry* entry);
+MDK_API int MDK_ProgramMetadataAll(const mdkProgramInfo*, mdkStringMapEntry* out, int cap);
 
 typedef struct mdkMediaInfo
 {
@@ -154,6 +158,14 @@ typedef struct mdkMediaInfo
 
 /* see document of mdkStringMapEntry */
 MDK_API bool MDK_MediaMetadata(const mdkMediaInfo*, mdkStringMapEntry* entry);
+/*
+  \brief MDK_MediaMetadataAll
+  Fill at most cap entries of all metadata in key order with no allocation. The same for MDK_XXXStreamMetadataAll and MDK_ProgramMetadataAll.
+  Strings are valid as long as the info is valid. An entry can be passed to MDK_MediaMetadata() to continue iteration.
+  \param out can be null to get the count
+  \return total number of entries
+ */
+MDK_API int MDK_MediaMetadataAll(const mdkMediaInfo*, mdkStringMapEntry* out, int cap);
 
 #ifdef __cplusplus
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2025 WangBin <wbsecg1 at gmail.com>
+ * Copyright (c) 2019-2026 WangBin <wbsecg1 at gmail.com>
  * This file is part of MDK
  * MDK SDK: https://github.com/wang-bin/mdk-sdk
  * Free for opensource softwares or non-commercial use.
@@ -10,6 +10,7 @@
 #pragma once
 #include "global.h"
 #include "RenderAPI.h"
+#include "AudioFrame.h"
 #include <stddef.h>
 
 #ifdef __cplusplus
@@ -63,6 +64,48 @@ typedef struct mdkAudioCallback {
     void* opaque;
 } mdkAudioCallback;
 
+/*!
+  \brief mdkVideoViewCallback
+  Read only frame callback. frame is a borrowed view owned by player and only valid in callback. No heap allocation and no atomic reference counting.
+  DO NOT keep, replace or mdkVideoFrameAPI_ref()/unref() the frame. Use frame->to() to create a new frame if the data is required after callback returns.
+  Debug build asserts if the view is referenced.
+*/
+typedef struct mdkVideoViewCallback {
+    void (*cb)(const struct mdkVideoFrameAPI* frame, int track, void* opaque);
+    void* opaque;
+} mdkVideoViewCallback;
+
+typedef struct mdkAudioViewCallback {
+    void (*cb)(const struct mdkAudioFrameAPI* frame, int track, void* opaque);
+    void* opaque;
+} mdkAudioViewCallback;
+
+/*!
+  \brief mdkVideoBatchCallback
+  Deliver a batch of frames in 1 call to reduce cross language calls.
+  \param frames array of count frames, can not be replaced. Frames are released after callback returns, use mdkVideoFrameAPI_ref() to keep a frame.
+  \param tracks track of each frame
+*/
+typedef struct mdkVideoBatchCallback {
+    void (*cb)(struct mdkVideoFrameAPI* const* frames, const int* tracks, int count, void* opaque);
+    void* opaque;
+} mdkVideoBatchCallback;
+
+typedef struct mdkAudioBatchCallback {
+    void (*cb)(struct mdkAudioFrameAPI* const* frames, const int* tracks, int count, void* opaque);
+    void* opaque;
+} mdkAudioBatchCallback;
+
+typedef enum MDK_FrameQueuePolicy {
+    MDK_FrameQueuePolicy_Block,      /* decoder waits for free space, i.e. frames acquired by user. not blocked if player is stopped */
+    MDK_FrameQueuePolicy_DropOldest, /* the oldest queued frame is dropped to push a new one */
+} MDK_FrameQueuePolicy;
+
+typedef enum MDK_ReverseDropPolicy {
+    MDK_ReverseDropPolicy_Wait, /* presentation clock stops when reverse buffer is empty, no frame is dropped unless a gop is larger than the memory cap */
+    MDK_ReverseDropPolicy_Late, /* presentation clock keeps running, late frames are dropped */
+} MDK_ReverseDropPolicy;
+
 typedef struct SwitchBitrateCallback {
     void (*cb)(bool, void* opaque);
     void* opaque;
@@ -98,6 +141,13 @@ typedef struct mdkMediaEventCallback {
 typedef struct mdkLoopCallback {
     void (*cb)(int, void* opaque);
     void* opaque;
+/*!
+  \brief cb2
+  Used instead of cb if not null. Called when the 1st video frame after loop point is delivered by decoder.
+  \param count current loop count elapsed
+  \param gap loop transition gap in milliseconds: interval of the last video frame before loop point and the 1st one after it, minus normal frame interval. -1 if no video
+ */
+    void (*cb2)(int count, int64_t gap, void* opaque);
 } mdkLoopCallback;
 
 typedef struct mdkSnapshotRequest {
@@ -141,12 +191,62 @@ typedef struct mdkSyncCallback {
     void* opaque;
 } mdkSyncCallback;
 
+/*!
+  \brief mdkScrubStats
+  Statistics of Player.scrub(). latency is from scrub() call to seek finished, in milliseconds
+ */
+typedef struct mdkScrubStats {
+    int64_t requests;
+    int64_t seeks;      /* number of seeks performed */
+    int64_t coalesced;  /* number of requests dropped because a newer request arrives before seeking */
+    int64_t last_latency;
+    int64_t mean_latency;
+    int64_t max_latency;
+} mdkScrubStats;
+
+/*!
+  \brief mdkFrameCacheStats
+  Statistics of decoded frame cache(Player.setFrameCache()). A lookup is a backward frame step, a forward frame step from a frame presented from cache, or an accurate seek when not playing
+ */
+typedef struct mdkFrameCacheStats {
+    int64_t hits;
+    int64_t misses;
+    int frames;         /* number of cached frames */
+    int64_t bytes;      /* estimated memory of cached frames */
+    int64_t budget;
+} mdkFrameCacheStats;
+
+/*!
+  \brief mdkReverseStats
+  Statistics of current reverse playback
+ */
+typedef struct mdkReverseStats {
+    int frames;         /* number of frames in reverse buffer */
+    int64_t bytes;      /* estimated memory of frames in reverse buffer */
+    int64_t presented;
+    int64_t dropped;    /* late frames, and frames dropped to decode a gop in memory cap */
+    int64_t underruns;  /* times reverse buffer is empty because decoding can not keep up */
+    int64_t gops;       /* number of decoded gops */
+    bool finished;      /* the first frame is presented */
+} mdkReverseStats;
+
 typedef struct mdkSubtitleCallback {
     void (*cb)(const char* text, void* opaque);
     void* opaque;
     void (*cb2)(double start, double end, const char* texts[], int textCount, void* opaque);
 } mdkSubtitleCallback;
 
+/*!
+  \brief mdkFramePoolStats
+  frame handles passed to onVideo/onAudio callback are recycled via a per player pool.
+  hits: handles reused from the pool. misses: handles allocated from heap because pool is empty.
+ */
+typedef struct mdkFramePoolStats {
+    int64_t hits;
+    int64_t misses;
+    int capacity;
+} mdkFramePoolStats;
+
 
 typedef struct mdkPlayerAPI {
     struct mdkPlayer* object;
@@ -201,9 +301,14 @@ typedef struct mdkPlayerAPI {
   \param flags seek flag if startPosition != 0.
   For fast seek(has flag SeekFlag::Fast), the first frame is a key frame whose timestamp >= startPosition
   For accurate seek(no flag SeekFlag::Fast), the first frame is the nearest frame whose timestamp <= startPosition, but the position passed to callback is the key frame position <= startPosition
+  If probe cache(MDK_setProbeCacheDir()) hits, mediaInfo() returns the cached info before the media is loaded. cb is still called once.
  */
     void (*prepare)(struct mdkPlayer*, int64_t startPosition, mdkPrepareCallback cb, enum MDKSeekFlag flags);
-    const struct mdkMediaInfo* (*mediaInfo)(struct mdkPlayer*); /* NOT IMPLEMENTED*/
+/*!
+  \brief mediaInfo
+  The result is converted again only if media info is changed, see mediaInfoChanged(). Pointers in the previous result are invalid after conversion.
+ */
+    const struct mdkMediaInfo* (*mediaInfo)(struct mdkPlayer*);
 
 /*!
   \brief setState
@@ -539,6 +644,188 @@ NOTE:
 */
     void (*setAudioMix)(struct mdkPlayer*, const float* mat, int rows, int cols);
     void (*onSubtitleText)(struct mdkPlayer*, mdkSubtitleCallback cb, bool plainText, MDK_CallbackToken* token);
+/*!
+  \brief framePoolStats
+  Get statistics of frame handle pool for onVideo(type is MDK_MediaType_Video) or onAudio(type is MDK_MediaType_Audio) callback.
+ */
+    void (*framePoolStats)(struct mdkPlayer*, MDK_MediaType type, mdkFramePoolStats* stats);
+/*!
+  \brief setFramePoolCapacity
+  Set max number of preallocated frame handles kept by the pool of type. Default is 8, max is 64, 0 disables pooling.
+  Handles are allocated from heap if all pooled handles are in use, e.g. referenced by user.
+ */
+    void (*setFramePoolCapacity)(struct mdkPlayer*, MDK_MediaType type, int capacity);
+/*!
+  \brief onVideoView
+  Set a read only callback invoked before delivering frame to renderers. Frame can not be modified or replaced, see mdkVideoViewCallback.
+  onVideoView() and onVideo() replace each other's callback.
+ */
+    void (*onVideoView)(struct mdkPlayer*, mdkVideoViewCallback cb);
+/*!
+  \brief onAudioView
+  Same as onVideoView() for audio frames. onAudioView() and onAudio() replace each other's callback.
+ */
+    void (*onAudioView)(struct mdkPlayer*, mdkAudioViewCallback cb);
+/*!
+  \brief onVideoBatch
+  Set a callback invoked with collected frames when maxFrames frames are collected, or maxDelay milliseconds elapsed since the first collected frame.
+  If maxDelay > 0, a timer thread delivers pending frames in time if no new frame arrives, e.g. paused, stalled or a slow source, so the callback can be invoked in that thread. The end of stream frame is always delivered immediately.
+  Pending frames are dropped if the callback is removed or replaced. Frame pool capacity(setFramePoolCapacity()) should be >= maxFrames to avoid allocations.
+  \param maxDelay <= 0: no time limit
+  onVideoBatch(), onVideoView() and onVideo() replace each other's callback.
+ */
+    void (*onVideoBatch)(struct mdkPlayer*, mdkVideoBatchCallback cb, int maxFrames, int maxDelay);
+/*!
+  \brief onAudioBatch
+  Same as onVideoBatch() for audio frames. onAudioBatch(), onAudioView() and onAudio() replace each other's callback.
+ */
+    void (*onAudioBatch)(struct mdkPlayer*, mdkAudioBatchCallback cb, int maxFrames, int maxDelay);
+/*!
+  \brief setVideoFrameQueue
+  Enable pull mode for decoded video frames. Frames are pushed to a bounded lock-free queue and acquired by user in any thread, instead of invoking callbacks in decoder thread.
+  Frames are still delivered to renderers.
+  \param capacity max number of queued frames. <= 0: disable pull mode, and wake up acquireVideoFrame() callers
+  \param policy what to do if queue is full
+  setVideoFrameQueue(), onVideoBatch(), onVideoView() and onVideo() replace each other's callback.
+ */
+    void (*setVideoFrameQueue)(struct mdkPlayer*, int capacity, MDK_FrameQueuePolicy policy);
+/*!
+  \brief acquireVideoFrame
+  Acquire the oldest queued frame. MUST be released by releaseVideoFrame() or mdkVideoFrameAPI_unref()
+  \param timeout milliseconds to wait if queue is empty. 0: no wait, < 0: wait until a frame is queued or pull mode is disabled
+  \param track track of the frame. can be null
+  \return null if no frame
+ */
+    struct mdkVideoFrameAPI* (*acquireVideoFrame)(struct mdkPlayer*, int timeout, int* track);
+    void (*releaseVideoFrame)(struct mdkPlayer*, struct mdkVideoFrameAPI** frame);
+/*!
+  \brief videoFrameQueueSize
+  \param dropped number of frames dropped because queue is full or player is stopped. can be null
+  \return number of queued frames
+ */
+    int (*videoFrameQueueSize)(struct mdkPlayer*, int64_t* dropped);
+/*!
+  \brief setAudioReadBuffer
+  Enable pull mode for decoded audio. Frames are converted to the given interleaved format in decoder thread, and written to a lock-free single producer single consumer ring buffer, then read by readAudio().
+  Audio output is not affected. If multiple audio tracks are active, only the first active track is written.
+  \param format sample format. planar formats are treated as interleaved
+  \param frames ring buffer capacity in frames(samples per channel). <= 0: disable pull mode
+  setAudioReadBuffer(), onAudioBatch(), onAudioView() and onAudio() replace each other's callback.
+ */
+    void (*setAudioReadBuffer)(struct mdkPlayer*, enum MDK_SampleFormat format, int channels, int sampleRate, int frames);
+/*!
+  \brief readAudio
+  Read interleaved pcm in the format of setAudioReadBuffer(). Only 1 thread can read.
+  If less than requested frames are available, rest of dst is filled with silence and an underrun is counted.
+  \return number of frames read from buffer
+ */
+    int (*readAudio)(struct mdkPlayer*, void* dst, int frames);
+/*!
+  \brief audioReadBufferSize
+  \param underruns number of readAudio() calls without enough frames. can be null
+  \param overruns number of decoded frames dropped or truncated because buffer is full. can be null
+  \return number of readable frames
+ */
+    int (*audioReadBufferSize)(struct mdkPlayer*, int64_t* underruns, int64_t* overruns);
+/*!
+  \brief setEventQueue
+  Enable polling mode for events. Events are pushed to a fixed capacity lock-free queue in the thread raising the event, and polled by pollEvents() in user thread.
+  The oldest event is dropped and an overflow is counted if queue is full. Callbacks set by onEvent() are not affected.
+  \param capacity max number of queued events. <= 0: disable polling mode
+ */
+    void (*setEventQueue)(struct mdkPlayer*, int capacity);
+/*!
+  \brief pollEvents
+  Pop at most max queued events in order. Only 1 thread can poll.
+  category and detail strings of polled events are valid until next pollEvents() call or setEventQueue().
+  \return number of events filled in out
+ */
+    int (*pollEvents)(struct mdkPlayer*, mdkMediaEvent* out, int max);
+/*!
+  \brief eventQueueSize
+  \param overflows number of events dropped because queue is full. can be null
+  \return number of queued events
+ */
+    int (*eventQueueSize)(struct mdkPlayer*, int64_t* overflows);
+/*!
+  \brief mediaInfoChanged
+  Check whether media info is changed since the given generation without converting to mdkMediaInfo if not changed.
+  If no media status change, decoder or metadata event and setMedia() since the last check, it's an integer compare.
+  Otherwise media info is compared by a hash of its fields except codec extra data and cover images, which costs O(size of media info) including metadata strings.
+  Call in the same thread as mediaInfo().
+  \param generation in: generation of previous check, 0 for the 1st check. out: current generation. can be null
+  \return true if changed
+ */
+    bool (*mediaInfoChanged)(struct mdkPlayer*, int64_t* generation);
+/*!
+  \brief scrub
+  Coalesced seek for dragging a timeline. At most 1 seek is running and only the latest request is pending, so the final position is always the last requested one.
+  A pending request is dropped and its callback is called with -2 when a newer request arrives. A running accurate seek is abandoned(callback called with -2 immediately) when a newer request arrives.
+  \param dragging true: fast key frame seek for preview, false: accurate seek, e.g. when the timeline slider is released
+  \param cb the same as seek(). -2 if dropped
+ */
+    void (*scrub)(struct mdkPlayer*, int64_t pos, bool dragging, mdkSeekCallback cb);
+    void (*scrubStats)(struct mdkPlayer*, mdkScrubStats* stats);
+/*!
+  \brief setKeyframeIndex
+  Enable key frame index of current media. Key frame timestamps are learned from results of key frame seeks, and loaded from probe cache dir(MDK_setProbeCacheDir()) if persisted.
+  If the index is complete, a seek with flags KeyFrame|Backward|FromStart goes to the indexed key frame <= target directly as a forward key frame seek, instead of searching backward.
+  An incomplete index(learned from seeks only) is never used for seeking.
+  Accurate seeks are NOT faster: the C api can not pass a key frame or byte offset to the core, so the core still searches the key frame and decodes to the target.
+  Seek latency with and without the index can be measured by bench/seek.cpp.
+  \param background build the complete index by key frame seeks with a hidden player(no audio and rendering) in a background thread. The complete index is persisted in probe cache dir.
+ */
+    void (*setKeyframeIndex)(struct mdkPlayer*, bool enable, bool background);
+/*!
+  \brief keyframes
+  \param t key frame timestamps in milliseconds, the same as results of seek(). can be null
+  \param count max number of timestamps can be filled in t
+  \param complete whether the index is completed by a background pass. can be null
+  \return total number of indexed key frames
+ */
+    int (*keyframes)(struct mdkPlayer*, int64_t* t, int count, bool* complete);
+/*!
+  \brief setFrameCache
+  Cache decoded video frames around current position for instant backward frame steps(seekWithFlags(-n, MDK_SeekFlag_Frame|MDK_SeekFlag_FromNow)) and short back-scrubs by accurate seeks.
+  Frames are cached when delivered by decoder, e.g. playback and forward frame steps, and the farthest frames from current position are evicted first.
+  If not playing, a frame step or accurate seek to a continuously cached frame is served by enqueueVideo() without decoding, and seek callback is called in seekWithFlags(). position() returns position of the presented frame,
+  and decoder seeks to it when playing or a seek can not be served.
+  Backward frame steps are served in order in a worker thread, and seek callback is called there. If missed, the gop before the presented frame is decoded by a hidden player(no audio and rendering) and cached,
+  so the following backward steps in the gop are hits.
+  Frames are cached after onVideo() and other video frame callbacks, and keep the buffers alive, so hardware decoders may run out of surfaces if the cache is too large.
+  \param mb max memory of cached frames in MB. <= 0: disable
+ */
+    void (*setFrameCache)(struct mdkPlayer*, int mb);
+    void (*frameCacheStats)(struct mdkPlayer*, mdkFrameCacheStats* stats);
+/*!
+  \brief setReverseBuffer
+  Set reverse playback parameters, applied when reverse playback starts next time.
+  Reverse playback is enabled by a negative playback rate, and starts from current position if state is MDK_State_Playing, or when set to MDK_State_Playing.
+  GOPs are decoded backward by a hidden player(no audio and rendering) in a worker thread, and frames in reverse buffer are presented by enqueueVideo(), so audio is muted.
+  While playing backward, state() is MDK_State_Playing and position() is position of the presented frame. A seek or pause stops reverse playback at the presented frame, and setState(MDK_State_Playing) resumes. A MDK_SeekFlag_FromNow seek is an accurate seek relative to the presented frame, a frame step is estimated by frame rate.
+  A positive playback rate stops reverse playback, and plays forward from the presented frame.
+  \param mb memory cap of decoded frames in MB, including reverse buffer and the gop being decoded. A gop larger than half of the cap is decimated. default is 256
+  \param policy what to do if decoding can not keep up
+ */
+    void (*setReverseBuffer)(struct mdkPlayer*, int mb, MDK_ReverseDropPolicy policy);
+    void (*reverseStats)(struct mdkPlayer*, mdkReverseStats* stats);
+/*!
+  \brief setTrickPlay
+  Key frame only playback for high playback rates, e.g. 8x~64x fast forward. Disabled by default.
+  If playback rate >= threshold, decoder is paused and forward key frame seeks to a virtual clock running at playback rate are performed, at most 1 running seek and 1 seek per interval.
+  So only key frames are decoded, and audio is muted. state() is MDK_State_Playing and position() is position of the presented key frame.
+  When playback rate drops below threshold, decoder seeks to the virtual clock accurately and plays normally. A seek or pause stops key frame only playback.
+  \param threshold min playback rate of key frame only playback. <= 0: disable
+  \param interval min interval between 2 seeks in milliseconds. default is 100
+ */
+    void (*setTrickPlay)(struct mdkPlayer*, float threshold, int interval);
+/*!
+  \brief setLoopCache
+  Keep demuxed packets of A-B loop range(setRange()) in memory, so loop restarts and seeks in range read no data from io again. Disabled by default.
+  Demuxer packet cache is enabled by properties "demux.buffer.ranges"(at least 2) and "demux.buffer.protocols"(protocol of current media is added), and the properties are restored when disabled.
+  Loop transition gap can be checked by mdkLoopCallback.cb2 of onLoop().
+ */
+    void (*setLoopCache)(struct mdkPlayer*, bool value);
     // TODO: updateRenderResources() // for vk, not in renderpass
 } mdkPlayerAPI;
 
@@ -549,6 +836,24 @@ MDK_API void mdkPlayerAPI_delete(const struct mdkPlayerAPI**);
   reset callbacks, release memory
 */
 MDK_API void mdkPlayerAPI_reset(const struct mdkPlayerAPI**, bool release);
+
+typedef struct mdkPlayerDeletedCallback {
+    void (*cb)(void* opaque);
+    void* opaque;
+} mdkPlayerDeletedCallback;
+/*!
+  \brief mdkPlayerAPI_deleteAsync
+  Reset callbacks and request to stop in current thread like mdkPlayerAPI_reset(), then destroy the player in a background thread.
+  Destroying a player may take a long time, e.g. waiting for network io. Pending players are not destroyed if the process exits.
+  *pp is set to null immediately.
+  \param cb called in the background thread when the player is destroyed. can be null
+ */
+MDK_API void mdkPlayerAPI_deleteAsync(const struct mdkPlayerAPI** pp, mdkPlayerDeletedCallback cb);
+/*!
+  \brief mdkPlayerAPI_pendingDeletes
+  \return number of players requested by mdkPlayerAPI_deleteAsync() and not destroyed yet
+ */
+MDK_API int mdkPlayerAPI_pendingDeletes();
 MDK_API void MDK_foreignGLContextDestroyed();
 
 #ifdef __cplusplus
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2026 WangBin <wbsecg1 at gmail.com>
+ * This file is part of MDK
+ * MDK SDK: https://github.com/wang-bin/mdk-sdk
+ * Free for opensource softwares or non-commercial use.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ */
+#pragma once
+#include "global.h"
+#include "MediaInfo.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+  \brief MDK_setProbeCacheDir
+  Enable persistent media probe cache for local files. Disabled by default.
+  When a media is loaded by Player.prepare(), its media info is saved in dir, 1 file per media, keyed by canonical path, file size and modification time.
+  Then Player.prepare() of the same file loads the media normally, but Player.mediaInfo() returns the cached info immediately until the media is loaded.
+  The prepare callback is not affected, it's invoked once when the media is loaded. A cache file is written only if missing or outdated.
+  MDK_probe() and MDK_probeMany() do not open the media if cache hits.
+  Cache files are written atomically and memory mapped to read, so multiple processes can share a cache dir.
+  Codec extra data and cover images are not cached.
+  \param dir cache directory, created if not exists. null or empty: disable cache
+ */
+MDK_API void MDK_setProbeCacheDir(const char* dir);
+
+typedef struct mdkProbeCallback {
+/*!
+  \brief cb
+  \param index index of url in the array
+  \param info media info, or null if failed to load. valid only in callback
+  \return false to stop probing the rest urls
+ */
+    bool (*cb)(int index, const char* url, const struct mdkMediaInfo* info, void* opaque);
+    void* opaque;
+/*!
+  \brief cb2
+  Used instead of cb if not null.
+  \param bytes bytes read by io of current process(including network file systems and sockets) while probing url, measured by os io counters.
+    0 for cached info. -1 if concurrency > 1(reads of workers are not separable) or not supported by os(only windows and linux are supported).
+    Reads of other threads in current process are also counted.
+ */
+    bool (*cb2)(int index, const char* url, const struct mdkMediaInfo* info, int64_t bytes, void* opaque);
+} mdkProbeCallback;
+
+typedef enum MDK_ProbeFlag {
+    MDK_ProbeFlag_Default = 0,
+/* Read container headers mostly, stream info is analyzed by at most 100ms or 32KB of packets and decoders are not opened.
+   Codec parameters are from demuxer, so frame rate, duration etc. may be inaccurate or missing. The result is not saved to probe cache.
+ */
+    MDK_ProbeFlag_HeaderOnly = 1,
+} MDK_ProbeFlag;
+
+/*!
+  \brief MDK_probeMany
+  Read media info of urls on a bounded worker pool, and wait for all urls are probed.
+  Each worker reuses 1 player without renderer or audio output, and the player is created only if probe cache(MDK_setProbeCacheDir()) misses.
+  cb is invoked in worker threads as soon as a url is probed, but never concurrently.
+  A url not loaded in 30s is failed, e.g. an unresponsive network url, and its player is stopped and destroyed in background.
+  \param concurrency number of workers, including the calling thread. <= 0: number of cpu cores
+  \return number of urls loaded successfully
+ */
+MDK_API int MDK_probeMany(const char** urls, int n, int concurrency, mdkProbeCallback cb);
+MDK_API int MDK_probeManyWithFlags(const char** urls, int n, int concurrency, MDK_ProbeFlag flags, mdkProbeCallback cb);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2026 WangBin <wbsecg1 at gmail.com>
+ * This file is part of MDK
+ * MDK SDK: https://github.com/wang-bin/mdk-sdk
+ * Free for opensource softwares or non-commercial use.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ */
+#pragma once
+#include "Player.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+  \brief mdkStandbyPool
+  Warm standby players for instant media switching, e.g. IPTV channel zapping.
+  Standby players are prepared(paused with the first frame decoded) without rendering. Switching to a standby player is a swap instead of setMedia() + prepare().
+  All players are owned by the pool. A player returned by promote() MUST be given back by recycle() when it's no longer active, and is destroyed by MDK_StandbyPool_delete().
+  The pool is not thread safe, call pool functions in the same thread.
+ */
+typedef struct mdkStandbyPool mdkStandbyPool;
+
+typedef struct mdkStandbyStats {
+    int standby;        /* number of standby players */
+    int prepared;       /* number of standby players whose media is prepared */
+    int64_t memory;     /* estimated memory of standby players in bytes: buffered packets + 1 decoded frame per video stream. sampled after prepared, a player not prepared yet is 0 */
+    int64_t promoted;   /* number of switches to standby players */
+    int64_t cold;       /* number of switches without standby players */
+    int64_t promoted_ttff; /* average time to first rendered frame of switches to standby players, in milliseconds. time is from promote() call to the 1st "render.video" event */
+    int64_t cold_ttff;  /* average time to first rendered frame of switches without standby players, in milliseconds */
+} mdkStandbyStats;
+
+/*!
+  \param maxStandby max number of standby players. The least recently preloaded player is evicted if exceeded.
+  \param memoryBudget max estimated memory of all standby players in bytes. <= 0: no limit. Checked by preload() and stats()
+ */
+MDK_API mdkStandbyPool* MDK_StandbyPool_new(int maxStandby, int64_t memoryBudget);
+MDK_API void MDK_StandbyPool_delete(mdkStandbyPool**);
+/*!
+  \brief MDK_StandbyPool_preload
+  Prepare url in a standby player if not exists. An idle player(recycled) is reused if possible.
+  \return the standby player, can be configured, e.g. setDecoders(), but MUST NOT be deleted
+ */
+MDK_API const mdkPlayerAPI* MDK_StandbyPool_preload(mdkStandbyPool*, const char* url);
+/*!
+  \brief MDK_StandbyPool_remove
+  Stop the standby player of url and make it idle.
+ */
+MDK_API void MDK_StandbyPool_remove(mdkStandbyPool*, const char* url);
+/*!
+  \brief MDK_StandbyPool_promote
+  Take the standby player of url in O(1), or set url to an idle or new player and prepare it if no standby player(a cold switch).
+  The result player is paused, call setState(MDK_State_Playing) and render it to play.
+ */
+MDK_API const mdkPlayerAPI* MDK_StandbyPool_promote(mdkStandbyPool*, const char* url);
+/*!
+  \brief MDK_StandbyPool_recycle
+  Stop a player returned by promote() and make it idle. Callbacks set by user are reset, and the player is stopped(waitFor(MDK_State_Stopped)) before reuse. *player is set to null.
+ */
+MDK_API void MDK_StandbyPool_recycle(mdkStandbyPool*, const mdkPlayerAPI** player);
+MDK_API void MDK_StandbyPool_stats(mdkStandbyPool*, mdkStandbyStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
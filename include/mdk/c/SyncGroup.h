@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2026 WangBin <wbsecg1 at gmail.com>
+ * This file is part of MDK
+ * MDK SDK: https://github.com/wang-bin/mdk-sdk
+ * Free for opensource softwares or non-commercial use.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ */
+#pragma once
+#include "Player.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+  \brief mdkSyncGroup
+  Synchronized playback of multiple players, e.g. video walls.
+  Members render frames by 1 shared master clock(via Player.onSync()) instead of their own clocks. Playback state, seek and playback rate are changed for all members by the group.
+  A player MUST leave the group before it's deleted.
+ */
+typedef struct mdkSyncGroup mdkSyncGroup;
+
+typedef struct mdkSyncDrift {
+    const struct mdkPlayerAPI* player;
+    int64_t drift;      /* member position - master clock, in milliseconds */
+    int64_t max_drift;  /* max absolute drift of all samples while the clock is running */
+    int64_t mean_drift; /* mean absolute drift of all samples while the clock is running */
+    int64_t samples;
+} mdkSyncDrift;
+
+MDK_API mdkSyncGroup* MDK_SyncGroup_new();
+/*!
+  \brief MDK_SyncGroup_delete
+  All members leave the group.
+ */
+MDK_API void MDK_SyncGroup_delete(mdkSyncGroup**);
+/*!
+  \brief MDK_SyncGroup_join
+  Replace sync callback of player with the master clock, and apply current playback rate of group.
+ */
+MDK_API void MDK_SyncGroup_join(mdkSyncGroup*, const struct mdkPlayerAPI* player);
+/*!
+  \brief MDK_SyncGroup_leave
+  Remove sync callback of player, then the player uses its own clock.
+ */
+MDK_API void MDK_SyncGroup_leave(mdkSyncGroup*, const struct mdkPlayerAPI* player);
+/*!
+  \brief MDK_SyncGroup_setState
+  Set state of all members. Master clock runs in State_Playing, freezes in State_Paused, and is reset to 0 in State_Stopped.
+ */
+MDK_API void MDK_SyncGroup_setState(mdkSyncGroup*, MDK_State value);
+/*!
+  \brief MDK_SyncGroup_seek
+  Seek all members. Master clock freezes until all members finish seeking, then resumes from the 1st successful seek result.
+  While seeking, master clock is pos for an accurate seek from 0 or start, otherwise the position before seek.
+ */
+MDK_API void MDK_SyncGroup_seek(mdkSyncGroup*, int64_t pos, MDK_SeekFlag flags);
+MDK_API void MDK_SyncGroup_setPlaybackRate(mdkSyncGroup*, float value);
+/*!
+  \brief MDK_SyncGroup_position
+  \return master clock in milliseconds
+ */
+MDK_API int64_t MDK_SyncGroup_position(mdkSyncGroup*);
+/*!
+  \brief MDK_SyncGroup_drift
+  Sample drift of members, and get per member statistics.
+  \param out can be null
+  \return number of members. at most cap entries are filled in out
+ */
+MDK_API int MDK_SyncGroup_drift(mdkSyncGroup*, mdkSyncDrift* out, int cap);
+
+#ifdef __cplusplus
+}
+#endif
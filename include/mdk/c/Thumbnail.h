@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2026 WangBin <wbsecg1 at gmail.com>
+ * This file is part of MDK
+ * MDK SDK: https://github.com/wang-bin/mdk-sdk
+ * Free for opensource softwares or non-commercial use.
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ */
+#pragma once
+#include "global.h"
+#include "VideoFrame.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct mdkThumbnailOptions {
+    const int64_t* positions; /* in milliseconds, in any order. null: count evenly spaced positions of the media */
+    int count;
+    int width;          /* <= 0: computed from height and aspect ratio of video. both <= 0: width is 160 */
+    int height;         /* <= 0: computed from width and aspect ratio of video */
+    bool accurate;      /* true: decode the frame at each position. false: the key frame before each position, and non-key frames are skipped by decoder */
+    int concurrency;    /* number of decoders. positions are split into continuous ranges for decoders. <= 0: 1 */
+/* optional caller buffers for RGBA thumbnails, count buffers of at least stride * height bytes. buffers[i] is for positions[i]. width and height MUST be > 0 if set */
+    uint8_t** buffers;
+    int stride;         /* bytes per line of buffers. <= 0: 4 * width */
+/* optional file name pattern to save each thumbnail by VideoFrame.save(), with at most 1 integer conversion "%d" or "%0Nd" for index, e.g. "thumb%03d.jpg". "%%" is a literal '%'. thumbnails are not saved if the pattern contains other conversions */
+    const char* fileName;
+    float quality;      /* image quality for saving, [0, 1]. < 0: default */
+} mdkThumbnailOptions;
+
+typedef struct mdkThumbnailCallback {
+/*!
+  \brief cb
+  Invoked in decoder threads as soon as a thumbnail is generated, but never concurrently. Optional
+  \param index index of position
+  \param position requested position in milliseconds
+  \param frame RGBA thumbnail, or null if failed. timestamp is of the decoded frame. valid only in callback
+  \return false to stop generating the rest thumbnails
+ */
+    bool (*cb)(int index, int64_t position, const struct mdkVideoFrameAPI* frame, void* opaque);
+    void* opaque;
+} mdkThumbnailCallback;
+
+typedef struct mdkSpriteOptions {
+    int columns;        /* thumbnails per row. <= 0: 10 */
+    const char* image;  /* sprite sheet file saved by VideoFrame.save(). format is from file extension */
+    const char* vtt;    /* WebVTT index file, can be null. cue i is from position i to position i + 1(or the end of media) in sorted positions, with payload "imageUrl#xywh=x,y,w,h" */
+    const char* imageUrl; /* sprite sheet url in WebVTT cues. null: image */
+} mdkSpriteOptions;
+
+/*!
+  \brief MDK_thumbnails
+  Generate scaled thumbnails of a media without rendering. Positions are sorted and each decoder seeks forward only, then decoded frames are converted to RGBA and scaled(by optimized pixel format converter).
+  Outputs are caller buffers, image files and callback in options, at least 1 of them should be set.
+  All thumbnails have the same size, computed from the 1st decoded frame if width or height is not set. Opening the media and each seek wait at most 10s, a thumbnail is failed if timed out.
+  \return number of generated thumbnails
+ */
+MDK_API int MDK_thumbnails(const char* url, const mdkThumbnailOptions* opts, mdkThumbnailCallback cb);
+/*!
+  \brief MDK_thumbnailSprite
+  Generate thumbnails like MDK_thumbnails(), and pack them into a sprite sheet in sorted positions order, with a WebVTT index for players' timeline preview.
+  buffers, fileName of opts are also used. There is no callback, so all thumbnails are generated and can not be stopped.
+  Cells are of the same size as all thumbnails, and a failed thumbnail is an empty cell without cue.
+  \return number of thumbnails in the sprite sheet, or 0 if sprite sheet is not saved
+ */
+MDK_API int MDK_thumbnailSprite(const char* url, const mdkThumbnailOptions* opts, const mdkSpriteOptions* sprite);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2025 WangBin <wbsecg1 at gmail.com>
+ * Copyright (c) 2020-2026 WangBin <wbsecg1 at gmail.com>
  * This file is part of MDK
  * MDK SDK: https://github.com/wang-bin/mdk-sdk
  * Free for opensource softwares or non-commercial use.
@@ -135,7 +135,17 @@ typedef struct mdkVideoFrameAPI {
     bool (*fromGL)();
     bool (*fromDX12)();
     bool (*toHost)(struct mdkVideoFrame*);
-    void* reserved[8];
+/*!
+  \brief size
+  Struct size returned from runtime.
+  1. size == 0: old runtime without extendable size support.
+  2. size > 0: new runtime with extendable size support. Before using members added later, if offsetof(mdkVideoFrameAPI, Member) < size, it's safe to use the member
+*/
+    union {
+        void* reserved2;
+        int size;
+    };
+    void* reserved[7];
 } mdkVideoFrameAPI;
 
 
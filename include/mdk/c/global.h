@@ -17,7 +17,7 @@
     (((major&0xff)<<16) | ((minor&0xff)<<8) | (patch&0xff))
 #define MDK_MAJOR 0
 #define MDK_MINOR 37
-#define MDK_MICRO 0
+#define MDK_MICRO 1
 #define MDK_VERSION MDK_VERSION_INT(MDK_MAJOR, MDK_MINOR, MDK_MICRO)
 #define MDK_VERSION_CHECK(a, b, c) (MDK_VERSION >= MDK_VERSION_INT(a, b, c))
 
@@ -231,6 +231,39 @@ MDK_API void MDK_setGlobalOptionPtr(const char* key, void* value);
 MDK_API bool MDK_getGlobalOptionString(const char* key, const char** value);
 MDK_API bool MDK_getGlobalOptionInt32(const char* key, int* value);
 MDK_API bool MDK_getGlobalOptionPtr(const char* key, void** value);
+/*!
+  \brief EventCategory
+  Interned id of known mdkMediaEvent.category. Unknown if not listed.
+ */
+typedef enum MDK_EventCategory {
+    MDK_EventCategory_Unknown,
+    MDK_EventCategory_RenderVideo,      /* "render.video" */
+    MDK_EventCategory_DecoderAudio,     /* "decoder.audio" */
+    MDK_EventCategory_DecoderVideo,     /* "decoder.video" */
+    MDK_EventCategory_DecoderSubtitle,  /* "decoder.subtitle" */
+    MDK_EventCategory_Video,            /* "video" */
+    MDK_EventCategory_ReaderBuffering,  /* "reader.buffering" */
+    MDK_EventCategory_ThreadAudio,      /* "thread.audio" */
+    MDK_EventCategory_ThreadVideo,      /* "thread.video" */
+    MDK_EventCategory_ThreadSubtitle,   /* "thread.subtitle" */
+    MDK_EventCategory_Snapshot,         /* "snapshot" */
+    MDK_EventCategory_CC,               /* "cc" */
+} MDK_EventCategory;
+
+/*!
+  \brief EventDetail
+  Interned id of known mdkMediaEvent.detail. Unknown if not listed, e.g. decoder name, file path or error string.
+ */
+typedef enum MDK_EventDetail {
+    MDK_EventDetail_Unknown,
+    MDK_EventDetail_FirstFrame, /* "1st_frame" */
+    MDK_EventDetail_Open,       /* "open" */
+    MDK_EventDetail_Size,       /* "size" */
+} MDK_EventDetail;
+
+MDK_API MDK_EventCategory MDK_eventCategory(const char* category);
+MDK_API MDK_EventDetail MDK_eventDetail(const char* detail);
+
 /*
   events:
   {timestamp(ms), "render.video", "1st_frame"}: when the first frame is rendererd
@@ -258,6 +291,15 @@ typedef struct mdkMediaEvent {
             int height;
         } video;
     };
+/*!
+  \brief size
+  Struct size set by runtime. Members after the union are added in 0.37.1, and the struct created by an older runtime ends before size.
+  1. MDK_version() < MDK_VERSION_INT(0, 37, 1): old runtime, size and the members below MUST NOT be read.
+  2. otherwise, if offsetof(mdkMediaEvent, Member) < size, it's safe to use the member
+*/
+    int size;
+    MDK_EventCategory category_id; /* interned category, can be used in switch instead of comparing strings */
+    MDK_EventDetail detail_id;
 } mdkMediaEvent;
 
 /*
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2025 WangBin <wbsecg1 at gmail.com>
+ * Copyright (c) 2020-2026 WangBin <wbsecg1 at gmail.com>
  * This file is part of MDK
  * MDK SDK: https://github.com/wang-bin/mdk-sdk
  * Free for opensource softwares or non-commercial use.
@@ -13,3 +13,7 @@
 #include "VideoFrame.h"
 #include "RenderAPI.h"
 #include "Player.h"
+#include "Probe.h"
+#include "Standby.h"
+#include "SyncGroup.h"
+#include "Thumbnail.h"